@@ -0,0 +1,43 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ClientPushReceiver.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include "SoapyRPCSocket.hpp"
+#include "SoapyRPCUnpacker.hpp"
+#include <SoapySDR/Logger.hpp>
+
+ClientPushReceiver::ClientPushReceiver(SoapyRPCSocket &sock, std::mutex &deviceMutex):
+    _sock(sock),
+    _deviceMutex(deviceMutex),
+    _done(false)
+{
+    _thread = std::thread(&ClientPushReceiver::receiveLoop, this);
+}
+
+ClientPushReceiver::~ClientPushReceiver(void)
+{
+    _done = true;
+    _thread.join();
+}
+
+void ClientPushReceiver::receiveLoop(void)
+{
+    while (not _done)
+    {
+        if (not _sock.selectRecv(SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
+
+        //a call in progress receives its reply and any pushes before it,
+        //so only read what is left once the device mutex is free
+        try
+        {
+            std::lock_guard<std::mutex> lock(_deviceMutex);
+            SoapyRPCUnpacker::recvPushes(_sock);
+        }
+        catch (const std::exception &ex)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "SoapyRemote push receive FAIL: %s", ex.what());
+            return;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+class SoapyRPCSocket;
+
+/*!
+ * Receive the messages that the server pushes on the control socket
+ * while no call is in progress (pushes during a call are handled by
+ * the call's unpacker). The thread takes the device mutex to read,
+ * so that it never reads a reply, and hands each message to the
+ * push handler registered for the socket and call.
+ */
+class ClientPushReceiver
+{
+public:
+    ClientPushReceiver(SoapyRPCSocket &sock, std::mutex &deviceMutex);
+
+    ~ClientPushReceiver(void);
+
+private:
+    void receiveLoop(void);
+
+    SoapyRPCSocket &_sock;
+    std::mutex &_deviceMutex;
+    std::atomic<bool> _done;
+    std::thread _thread;
+};
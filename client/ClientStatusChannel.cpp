@@ -0,0 +1,83 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ClientStatusChannel.hpp"
+#include "SoapyStreamEndpoint.hpp"
+#include "SoapyURLUtils.hpp"
+#include <SoapySDR/Errors.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <chrono>
+#include <stdexcept>
+
+//bound the queue of a stream that is never read
+#define STATUS_CHANNEL_MAX_QUEUE 1000
+
+ClientStatusChannel::ClientStatusChannel(const std::string &bindURL):
+    _reading(false)
+{
+    int ret = _sock.bind(bindURL);
+    if (ret != 0) throw std::runtime_error(
+        "SoapyRemote::setupStatusChannel("+bindURL+") -- bind FAIL: " + std::string(_sock.lastErrorMsg()));
+    SoapySDR::logf(SOAPY_SDR_INFO, "Client side status channel bound to %s", _sock.getsockname().c_str());
+}
+
+std::string ClientStatusChannel::getBindPort(void)
+{
+    return SoapyURL(_sock.getsockname()).getService();
+}
+
+int ClientStatusChannel::read(const int streamId, size_t &chanMask, int &flags, long long &timeNs, const long timeoutUs)
+{
+    const auto exitTime = std::chrono::high_resolution_clock::now() + std::chrono::microseconds(timeoutUs);
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (true)
+    {
+        //pop a message that was received for this stream
+        auto &queue = _queues[streamId];
+        if (not queue.empty())
+        {
+            const auto msg = queue.front();
+            queue.pop_front();
+            chanMask = msg.chanMask;
+            flags = msg.flags;
+            timeNs = msg.timeNs;
+            return msg.code;
+        }
+
+        const auto timeLeft = std::chrono::duration_cast<std::chrono::microseconds>(exitTime - std::chrono::high_resolution_clock::now());
+        if (timeLeft.count() <= 0) return SOAPY_SDR_TIMEOUT;
+
+        //another caller is receiving, wait for it to sort a message
+        if (_reading)
+        {
+            _cond.wait_for(lock, timeLeft);
+            continue;
+        }
+
+        //receive one message without the lock and sort it by stream ID
+        _reading = true;
+        lock.unlock();
+        int id = -1, code = 0, msgFlags = 0;
+        size_t msgMask = 0;
+        long long msgTime = 0;
+        bool ok = _sock.selectRecv(timeLeft.count());
+        if (ok) ok = SoapyStreamEndpoint::readStatusChannel(_sock, id, code, msgMask, msgFlags, msgTime) == 0;
+        lock.lock();
+        _reading = false;
+
+        if (ok)
+        {
+            auto &msgQueue = _queues[id];
+            if (msgQueue.size() >= STATUS_CHANNEL_MAX_QUEUE) msgQueue.pop_front();
+            msgQueue.push_back(StatusMessage{code, msgMask, msgFlags, msgTime});
+        }
+        _cond.notify_all();
+    }
+}
+
+void ClientStatusChannel::remove(const int streamId)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queues.erase(streamId);
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "SoapyRPCSocket.hpp"
+#include <cstddef>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+
+/*!
+ * The status channel receives the stream status of every datagram
+ * stream on a device connection with a single bound socket.
+ * Messages are sorted into a queue per stream ID; there is no thread,
+ * whichever caller of read() finds the socket idle receives for all.
+ */
+class ClientStatusChannel
+{
+public:
+    //! Bind the channel socket, throw on failure
+    ClientStatusChannel(const std::string &bindURL);
+
+    //! The bound port sent to the server
+    std::string getBindPort(void);
+
+    /*!
+     * Read the next status message for a stream.
+     * Return the status code or SOAPY_SDR_TIMEOUT.
+     */
+    int read(const int streamId, size_t &chanMask, int &flags, long long &timeNs, const long timeoutUs);
+
+    //! Discard the queued messages of a closed stream
+    void remove(const int streamId);
+
+private:
+    SoapyRPCSocket _sock;
+
+    struct StatusMessage
+    {
+        int code;
+        size_t chanMask;
+        int flags;
+        long long timeNs;
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::map<int, std::deque<StatusMessage>> _queues;
+    bool _reading; //one caller receives at a time
+};
@@ -3,13 +3,33 @@
 
 #include "ClientStreamData.hpp"
 #include "SoapyStreamEndpoint.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include "StreamRing.hpp"
+#include "SoapySocketPool.hpp"
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <SoapySDR/Constants.h>
+#include <SoapySDR/Errors.hpp>
 #include <cstring> //memcpy
 #include <cassert>
 #include <cstdint>
+#include <algorithm> //max
 
 ClientStreamData::ClientStreamData(void):
     streamId(-1),
+    streamSock(nullptr),
+    statusSock(nullptr),
+    socketPool(nullptr),
+    statusChannel(nullptr),
     endpoint(nullptr),
+    ring(nullptr),
+    ioDone(true),
+    ioError(0),
+    ioErrorReported(false),
+    ioFlush(false),
+    ioOverflows(0),
+    replay(false),
+    setupActivated(false),
     readHandle(0),
     readElemsLeft(0),
     scaleFactor(0.0),
@@ -18,6 +38,23 @@ ClientStreamData::ClientStreamData(void):
     return;
 }
 
+ClientStreamData::~ClientStreamData(void)
+{
+    //the unused status socket of a status channel stream is not pooled
+    if (socketPool != nullptr and statusChannel != nullptr)
+    {
+        socketPool->release(streamSock, nullptr);
+        delete statusSock;
+    }
+    else if (socketPool != nullptr) socketPool->release(streamSock, statusSock);
+    else
+    {
+        delete streamSock;
+        delete statusSock;
+    }
+    for (auto sock : stripeSocks) delete sock;
+}
+
 void ClientStreamData::convertRecvBuffs(void * const *buffs, const size_t numElems)
 {
     assert(endpoint != nullptr);
@@ -154,9 +191,6 @@ void ClientStreamData::convertRecvBuffs(void * const *buffs, const size_t numEle
 
 void ClientStreamData::convertSendBuffs(const void * const *buffs, const size_t numElems)
 {
-    assert(endpoint != nullptr);
-    assert(endpoint->getElemSize() != 0);
-    assert(endpoint->getNumChans() != 0);
     assert(not sendBuffs.empty());
 
     switch (convertType)
@@ -165,7 +199,8 @@ void ClientStreamData::convertSendBuffs(const void * const *buffs, const size_t
     case CONVERT_MEMCPY:
     ///////////////////////////
     {
-        size_t elemSize = endpoint->getElemSize();
+        //waveform upload streams do not have an endpoint
+        size_t elemSize = (endpoint != nullptr)?endpoint->getElemSize():SoapySDR::formatToSize(remoteFormat);
         for (size_t i = 0; i < sendBuffs.size(); i++)
         {
             std::memcpy(sendBuffs[i], buffs[i], numElems*elemSize);
@@ -283,3 +318,167 @@ void ClientStreamData::convertSendBuffs(const void * const *buffs, const size_t
     break;
     }
 }
+
+static SoapyStreamRing *makeStreamRing(SoapyStreamEndpoint *endpoint, const size_t ringBytes)
+{
+    assert(endpoint != nullptr);
+    const size_t numChans = endpoint->getNumChans();
+    const size_t chanBytes = endpoint->getBuffSize()*endpoint->getElemSize();
+    const size_t numSlots = std::max<size_t>(SOAPY_REMOTE_RING_MIN_SLOTS, ringBytes/(numChans*chanBytes));
+    SoapySDR::logf(SOAPY_SDR_INFO, "Client side stream ring of %d packets (%g MiB)",
+        int(numSlots), (numSlots*numChans*chanBytes)/(1024.0*1024.0));
+    return new SoapyStreamRing(numSlots, numChans, chanBytes);
+}
+
+void ClientStreamData::startPrefetch(const size_t ringBytes)
+{
+    ring = makeStreamRing(endpoint, ringBytes);
+    ioDone = false;
+    ioError = 0;
+    ioThread = std::thread(&ClientStreamData::recvPrefetchWork, this);
+}
+
+void ClientStreamData::startSendQueue(const size_t ringBytes)
+{
+    ring = makeStreamRing(endpoint, ringBytes);
+    ioDone = false;
+    ioError = 0;
+    ioErrorReported = false;
+    ioFlush = true;
+    ioThread = std::thread(&ClientStreamData::sendQueueWork, this);
+}
+
+void ClientStreamData::stopIoThread(void)
+{
+    if (ring == nullptr) return;
+
+    //wake the thread immediately, the send queue is flushed first
+    ioDone = true;
+    ring->close();
+    if (not ioFlush) endpoint->interrupt();
+    ioThread.join();
+
+    if (ioOverflows != 0) SoapySDR::logf(SOAPY_SDR_WARNING,
+        "Client side stream ring dropped %d packets", int(ioOverflows));
+
+    delete ring;
+    ring = nullptr;
+}
+
+void ClientStreamData::recvPrefetchWork(void)
+{
+    const size_t elemSize = endpoint->getElemSize();
+    std::vector<const void *> buffs(endpoint->getNumChans());
+    bool overflow = false;
+
+    while (not ioDone)
+    {
+        //drain the socket as fast as the packets arrive
+        if (not endpoint->waitRecv(SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
+        size_t handle = 0;
+        int flags = 0;
+        long long timeNs = 0;
+        const int ret = endpoint->acquireRecv(handle, buffs.data(), flags, timeNs);
+
+        //the endpoint failed (connection lost), stop receiving,
+        //reads return the error once the ring is drained
+        if (ret == SOAPY_SDR_STREAM_ERROR)
+        {
+            SoapySDR::log(SOAPY_SDR_ERROR, "Client side stream prefetch stopped on stream error");
+            ioError = ret;
+            ring->close();
+            return;
+        }
+
+        //report the dropped packets ahead of the next packet
+        if (overflow and ring->waitWrite(0))
+        {
+            const size_t slotHandle = ring->acquireWrite();
+            auto &slot = ring->getSlot(slotHandle);
+            slot.numElemsOrErr = SOAPY_SDR_OVERFLOW;
+            slot.flags = flags & SOAPY_SDR_HAS_TIME;
+            slot.timeNs = timeNs;
+            ring->releaseWrite(slotHandle);
+            overflow = false;
+        }
+
+        //the application fell behind, drop the packet but keep the
+        //endpoint flowing so the kernel socket buffer never backs up
+        if (not ring->waitWrite(0))
+        {
+            if (ret >= 0) endpoint->releaseRecv(handle);
+            if (not overflow) SoapySDR::log(SOAPY_SDR_SSI, "O");
+            overflow = true;
+            ioOverflows++;
+            continue;
+        }
+
+        //copy the packet into the ring, errors only carry the metadata
+        const size_t slotHandle = ring->acquireWrite();
+        auto &slot = ring->getSlot(slotHandle);
+        slot.numElemsOrErr = ret;
+        slot.flags = flags;
+        slot.timeNs = timeNs;
+        if (ret >= 0)
+        {
+            for (size_t i = 0; i < buffs.size(); i++)
+            {
+                std::memcpy(slot.buffs[i], buffs[i], size_t(ret)*elemSize);
+            }
+            endpoint->releaseRecv(handle);
+        }
+        ring->releaseWrite(slotHandle);
+    }
+}
+
+void ClientStreamData::sendQueueWork(void)
+{
+    const size_t elemSize = endpoint->getElemSize();
+    std::vector<void *> buffs(endpoint->getNumChans());
+
+    //on shutdown, keep sending until the queue is empty
+    while (ring->waitRead(SOAPY_REMOTE_SOCKET_TIMEOUT_US) or not ioDone)
+    {
+        if (not ring->waitRead(0)) continue;
+        const size_t slotHandle = ring->acquireRead();
+        const auto &slot = ring->getSlot(slotHandle);
+
+        //flow control blocks here rather than in the application
+        bool ready = false;
+        while (not (ready = endpoint->waitSend(SOAPY_REMOTE_SOCKET_TIMEOUT_US)))
+        {
+            if (ioDone) break;
+        }
+
+        //the remote end stopped acknowledging during shutdown
+        if (not ready)
+        {
+            ring->releaseRead(slotHandle);
+            SoapySDR::log(SOAPY_SDR_WARNING, "Client side send queue abandoned at shutdown");
+            return;
+        }
+
+        //the endpoint failed, stop sending, writes and the
+        //stream status report the error to the application
+        size_t handle = 0;
+        const int ret = endpoint->acquireSend(handle, buffs.data());
+        if (ret < 0)
+        {
+            ring->releaseRead(slotHandle);
+            SoapySDR::logf(SOAPY_SDR_ERROR, "Client side send queue stopped on error %d", ret);
+            ioError = ret;
+            ring->close();
+            return;
+        }
+
+        //the slots match the endpoint buffer size, so one slot is one packet
+        const size_t numElems = size_t(slot.numElemsOrErr);
+        for (size_t i = 0; i < buffs.size(); i++)
+        {
+            std::memcpy(buffs[i], slot.buffs[i], numElems*elemSize);
+        }
+        int flags = slot.flags;
+        endpoint->releaseSend(handle, numElems, flags, slot.timeNs);
+        ring->releaseRead(slotHandle);
+    }
+}
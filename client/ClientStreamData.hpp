@@ -5,8 +5,13 @@
 #include "SoapyRPCSocket.hpp"
 #include <vector>
 #include <string>
+#include <thread>
+#include <atomic>
 
 class SoapyStreamEndpoint;
+class SoapySocketPool;
+class ClientStatusChannel;
+class SoapyStreamRing;
 
 enum ConvertTypes
 {
@@ -22,6 +27,7 @@ enum ConvertTypes
 struct ClientStreamData
 {
     ClientStreamData(void);
+    ~ClientStreamData(void);
 
     //string formats in use
     std::string localFormat;
@@ -31,14 +37,49 @@ struct ClientStreamData
     int streamId;
 
     //datagram socket for stream endpoint
-    SoapyRPCSocket streamSock;
+    SoapyRPCSocket *streamSock;
 
     //datagram socket for status endpoint
-    SoapyRPCSocket statusSock;
+    SoapyRPCSocket *statusSock;
+
+    //additional tcp connections for a striped stream
+    std::vector<SoapyRPCSocket *> stripeSocks;
+
+    //the pool that datagram sockets are returned to (when set)
+    SoapySocketPool *socketPool;
+
+    //the shared status channel (when set) replaces the status socket
+    ClientStatusChannel *statusChannel;
 
     //local side of the stream endpoint
     SoapyStreamEndpoint *endpoint;
 
+    //optional user-space ring between the application and the endpoint:
+    //receive prefetch drains the endpoint into the ring,
+    //the transmit queue drains the ring into the endpoint
+    SoapyStreamRing *ring;
+    std::thread ioThread;
+    std::atomic<bool> ioDone;
+    std::atomic<int> ioError; //the endpoint failed, the thread stopped
+    std::atomic<bool> ioErrorReported; //by readStreamStatus
+    bool ioFlush;
+    size_t ioOverflows;
+    void startPrefetch(const size_t ringBytes);
+    void startSendQueue(const size_t ringBytes);
+    void stopIoThread(void);
+    void recvPrefetchWork(void);
+    void sendQueueWork(void);
+
+    //replay streams activate with a history window
+    bool replay;
+
+    //the setup call activated the stream (remote:activate)
+    bool setupActivated;
+
+    //waveform upload streams buffer samples until the end of burst
+    std::string waveform;
+    std::vector<std::string> waveformBuffs;
+
     //buffer pointers to read/write API
     std::vector<const void *> recvBuffs;
     std::vector<void *> sendBuffs;
@@ -0,0 +1,84 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ClientSubscriptions.hpp"
+#include "SoapyRPCSocket.hpp"
+#include "SoapyRPCUnpacker.hpp"
+#include <algorithm>
+
+static std::string subscriptionKey(const std::string &what, const int direction, const int channel)
+{
+    return std::to_string(direction) + ":" + std::to_string(channel) + ":" + what;
+}
+
+ClientSubscriptions::ClientSubscriptions(SoapyRPCSocket &sock):
+    _sock(sock)
+{
+    SoapyRPCUnpacker::setPushHandler(_sock, SOAPY_REMOTE_PUSH_SENSOR, [this](SoapyRPCUnpacker &unpacker)
+    {
+        this->handlePush(unpacker);
+    });
+}
+
+ClientSubscriptions::~ClientSubscriptions(void)
+{
+    SoapyRPCUnpacker::setPushHandler(_sock, SOAPY_REMOTE_PUSH_SENSOR, SoapyRPCUnpacker::PushHandler());
+}
+
+void ClientSubscriptions::setPeriod(const std::string &what, const int direction, const int channel, const long long periodUs)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto key = subscriptionKey(what, direction, channel);
+    if (periodUs <= 0) _snapshots.erase(key);
+    else _snapshots[key].periodUs = std::max<long long>(periodUs, SOAPY_REMOTE_SUBSCRIBE_MIN_PERIOD_US);
+}
+
+bool ClientSubscriptions::get(const std::string &what, const int direction, const int channel, std::string &value)
+{
+    Snapshot snapshot;
+    if (not this->getFresh(subscriptionKey(what, direction, channel), snapshot)) return false;
+    value = snapshot.value;
+    return true;
+}
+
+bool ClientSubscriptions::getTime(long long &timeNs)
+{
+    Snapshot snapshot;
+    if (not this->getFresh(subscriptionKey(SOAPY_REMOTE_KWARG_SUBSCRIBE_TIME, 0, -1), snapshot)) return false;
+    const auto elapsed = std::chrono::steady_clock::now() - snapshot.receivedTime;
+    timeNs = snapshot.timeNs + std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return true;
+}
+
+bool ClientSubscriptions::getFresh(const std::string &key, Snapshot &snapshot)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _snapshots.find(key);
+    if (it == _snapshots.end() or not it->second.received) return false;
+    const auto maxAge = std::chrono::microseconds(it->second.periodUs*SOAPY_REMOTE_SUBSCRIBE_FRESH_PERIODS);
+    if (std::chrono::steady_clock::now() - it->second.receivedTime > maxAge) return false;
+    snapshot = it->second;
+    return true;
+}
+
+void ClientSubscriptions::handlePush(SoapyRPCUnpacker &unpacker)
+{
+    std::string what, value;
+    char direction = 0;
+    int channel = 0;
+    long long timeNs = 0;
+    unpacker & what;
+    unpacker & direction;
+    unpacker & channel;
+    unpacker & value;
+    unpacker & timeNs;
+
+    //pushes that were in flight when unsubscribing are dropped
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _snapshots.find(subscriptionKey(what, direction, channel));
+    if (it == _snapshots.end()) return;
+    it->second.received = true;
+    it->second.value = value;
+    it->second.timeNs = timeNs;
+    it->second.receivedTime = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "SoapyRemoteDefs.hpp"
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <map>
+
+class SoapyRPCSocket;
+class SoapyRPCUnpacker;
+
+/*!
+ * Keep the latest values that the server pushes for subscriptions.
+ * Pushes that arrive during a call are handled by the call's unpacker,
+ * the client push receiver handles those that arrive between calls.
+ */
+class ClientSubscriptions
+{
+public:
+    ClientSubscriptions(SoapyRPCSocket &sock);
+
+    ~ClientSubscriptions(void);
+
+    //! Record the subscription period that decides freshness (0 removes)
+    void setPeriod(const std::string &what, const int direction, const int channel, const long long periodUs);
+
+    //! Get a fresh value, return false when there is none
+    bool get(const std::string &what, const int direction, const int channel, std::string &value);
+
+    //! Get the pushed hardware time advanced by the local time since the push
+    bool getTime(long long &timeNs);
+
+private:
+    void handlePush(SoapyRPCUnpacker &unpacker);
+
+    struct Snapshot
+    {
+        Snapshot(void):
+            periodUs(0),
+            received(false),
+            timeNs(0)
+        {
+            return;
+        }
+        long long periodUs;
+        bool received;
+        std::string value;
+        long long timeNs;
+        std::chrono::steady_clock::time_point receivedTime;
+    };
+    bool getFresh(const std::string &key, Snapshot &snapshot);
+
+    SoapyRPCSocket &_sock;
+    std::mutex _mutex;
+    std::map<std::string, Snapshot> _snapshots;
+};
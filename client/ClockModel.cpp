@@ -0,0 +1,153 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ClockModel.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Logger.hpp>
+#include <algorithm> //min, max
+#include <chrono>
+#include <cstdlib> //llabs
+#include <cmath>
+
+static long long localTimeNs(void)
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+ClientClockModel::ClientClockModel(const std::function<long long(void)> &sample, const long periodUs, const long long toleranceNs):
+    _sample(sample),
+    _periodUs(periodUs),
+    _toleranceNs(toleranceNs),
+    _resets(0),
+    _done(false)
+{
+    _thread = std::thread(&ClientClockModel::sampleLoop, this);
+}
+
+ClientClockModel::~ClientClockModel(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _cond.notify_all();
+    }
+    _thread.join();
+}
+
+bool ClientClockModel::get(long long &timeNs)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    long long errorNs = 0;
+    if (not this->fit(localTimeNs(), timeNs, errorNs)) return false;
+    return errorNs <= _toleranceNs;
+}
+
+void ClientClockModel::reset(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _samples.clear();
+    _resets++;
+    _cond.notify_all();
+}
+
+void ClientClockModel::sampleLoop(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (not _done)
+    {
+        //sample quickly until the model has enough samples
+        const bool filling = _samples.size() < SOAPY_REMOTE_CLOCK_MIN_SAMPLES;
+        const unsigned resets = _resets;
+        lock.unlock();
+
+        ClockSample sample;
+        bool ok = true;
+        try
+        {
+            const auto t0 = localTimeNs();
+            sample.remoteNs = _sample();
+            const auto t1 = localTimeNs();
+            sample.localNs = t0 + (t1-t0)/2;
+            sample.rttNs = t1-t0;
+        }
+        catch (const std::exception &ex)
+        {
+            SoapySDR::logf(SOAPY_SDR_DEBUG, "ClientClockModel sample FAIL: %s", ex.what());
+            ok = false;
+        }
+
+        lock.lock();
+        if (ok and _resets == resets)
+        {
+            //samples from before a sampling outage are stale, and so are
+            //samples from before the remote time jumped without a reset
+            //(a time source event or another client setting the time)
+            long long timeNs = 0, errorNs = 0;
+            if (not _samples.empty() and sample.localNs - _samples.back().localNs > this->maxAgeNs())
+            {
+                SoapySDR::log(SOAPY_SDR_DEBUG, "ClientClockModel: samples expired, resampling");
+                _samples.clear();
+            }
+            else if (this->fit(sample.localNs, timeNs, errorNs) and
+                std::llabs(sample.remoteNs - timeNs) > errorNs + sample.rttNs/2 + _toleranceNs)
+            {
+                SoapySDR::log(SOAPY_SDR_DEBUG, "ClientClockModel: remote time jumped, resampling");
+                _samples.clear();
+            }
+            _samples.push_back(sample);
+            if (_samples.size() > SOAPY_REMOTE_CLOCK_MAX_SAMPLES) _samples.pop_front();
+        }
+        const long waitUs = filling?(_periodUs/SOAPY_REMOTE_CLOCK_MIN_SAMPLES):_periodUs;
+        _cond.wait_for(lock, std::chrono::microseconds(waitUs));
+    }
+}
+
+long long ClientClockModel::maxAgeNs(void) const
+{
+    return 1000LL*_periodUs*SOAPY_REMOTE_CLOCK_MAX_AGE_PERIODS;
+}
+
+bool ClientClockModel::fit(const long long localNs, long long &timeNs, long long &errorNs)
+{
+    if (_samples.size() < SOAPY_REMOTE_CLOCK_MIN_SAMPLES) return false;
+
+    //sampling stopped (the calls fail), dont extrapolate a stale fit
+    if (localNs - _samples.back().localNs > this->maxAgeNs()) return false;
+
+    //use the samples with the shortest round trips: a long round trip
+    //is usually queuing delay on one side and biases the midpoint
+    long long minRtt = _samples.front().rttNs;
+    for (const auto &s : _samples) minRtt = std::min(minRtt, s.rttNs);
+    const long long maxRtt = 2*minRtt + SOAPY_REMOTE_CLOCK_RTT_SLACK_NS;
+
+    //least squares fit of remote = offset + rate*(local - ref)
+    const long long ref = _samples.back().localNs;
+    const long long refRemote = _samples.back().remoteNs;
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (const auto &s : _samples)
+    {
+        if (s.rttNs > maxRtt) continue;
+        const double x = double(s.localNs - ref);
+        const double y = double(s.remoteNs - refRemote);
+        n += 1; sx += x; sy += y; sxx += x*x; sxy += x*y;
+    }
+    if (n < 2) return false;
+    const double det = n*sxx - sx*sx;
+    const double rate = (det > 0)?((n*sxy - sx*sy)/det):1.0;
+    const double offset = (sy - rate*sx)/n;
+
+    //the error bound is half the best round trip plus the worst residual
+    double maxResidual = 0;
+    for (const auto &s : _samples)
+    {
+        if (s.rttNs > maxRtt) continue;
+        const double x = double(s.localNs - ref);
+        const double y = double(s.remoteNs - refRemote);
+        maxResidual = std::max(maxResidual, std::abs(y - (offset + rate*x)));
+    }
+
+    timeNs = refRemote + (long long)(offset + rate*double(localNs - ref));
+    errorNs = minRtt/2 + (long long)(maxResidual);
+    return true;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <functional>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <deque>
+
+/*!
+ * A local model of the remote hardware clock.
+ * A thread samples the remote time periodically and records the local
+ * time before and after each sample; like NTP, the remote time is taken
+ * at the midpoint and half the round trip bounds the error.
+ * The model fits an offset and a rate to the best recent samples,
+ * so the hardware time can be answered without a round trip.
+ * The model is unused when sampling stops, and starts over
+ * when a sample shows that the remote time jumped.
+ */
+class ClientClockModel
+{
+public:
+    //! The sample function returns the remote hardware time in ns
+    ClientClockModel(const std::function<long long(void)> &sample, const long periodUs, const long long toleranceNs);
+
+    ~ClientClockModel(void);
+
+    /*!
+     * Get the modeled hardware time.
+     * \return false when the model's error bound exceeds the tolerance
+     */
+    bool get(long long &timeNs);
+
+    //! Discard the samples after the remote time was set
+    void reset(void);
+
+private:
+    void sampleLoop(void);
+    bool fit(const long long localNs, long long &timeNs, long long &errorNs);
+    long long maxAgeNs(void) const;
+
+    const std::function<long long(void)> _sample;
+    const long _periodUs;
+    const long long _toleranceNs;
+
+    struct ClockSample
+    {
+        long long localNs; //midpoint of the round trip
+        long long remoteNs;
+        long long rttNs;
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::deque<ClockSample> _samples;
+    unsigned _resets; //samples taken across a reset are stale
+    bool _done;
+    std::thread _thread;
+};
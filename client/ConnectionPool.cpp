@@ -0,0 +1,109 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ConnectionPool.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include "SoapyRPCSocket.hpp"
+#include <SoapySDR/Logger.hpp>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <map>
+
+/***********************************************************************
+ * idle connections by URL, most recently released last
+ **********************************************************************/
+struct IdleConnection
+{
+    SoapyRPCSocket *sock;
+    std::chrono::steady_clock::time_point expires;
+};
+
+static std::mutex &getPoolMutex(void)
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::map<std::string, std::vector<IdleConnection>> &getIdleConnections(void)
+{
+    static std::map<std::string, std::vector<IdleConnection>> idle;
+    return idle;
+}
+
+//close expired connections of every URL (call with the mutex held)
+static void expireIdleConnections(void)
+{
+    const auto now = std::chrono::steady_clock::now();
+    auto &idle = getIdleConnections();
+    for (auto it = idle.begin(); it != idle.end();)
+    {
+        auto &conns = it->second;
+        for (size_t i = 0; i < conns.size();)
+        {
+            if (conns[i].expires > now) i++;
+            else
+            {
+                delete conns[i].sock;
+                conns.erase(conns.begin()+i);
+            }
+        }
+        if (conns.empty()) idle.erase(it++);
+        else ++it;
+    }
+}
+
+/***********************************************************************
+ * pool entry points
+ **********************************************************************/
+int SoapyConnectionPool::connect(SoapyRPCSocket &sock, const std::string &url, const long timeoutUs)
+{
+    SoapyRPCSocket *pooled = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(getPoolMutex());
+        expireIdleConnections();
+        auto &idle = getIdleConnections();
+        const auto it = idle.find(url);
+        if (it != idle.end())
+        {
+            pooled = it->second.back().sock;
+            it->second.pop_back();
+            if (it->second.empty()) idle.erase(it);
+        }
+    }
+
+    //an idle connection should have nothing to read:
+    //readable means closed by the server (or a stray reply)
+    if (pooled != nullptr)
+    {
+        if (pooled->status() and not pooled->selectRecv(0))
+        {
+            SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyConnectionPool reusing connection to %s", url.c_str());
+            sock.swap(*pooled);
+            delete pooled;
+            return 0;
+        }
+        SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyConnectionPool discarding stale connection to %s", url.c_str());
+        delete pooled;
+    }
+
+    return sock.connect(url, timeoutUs);
+}
+
+void SoapyConnectionPool::release(SoapyRPCSocket &sock, const std::string &url)
+{
+    auto pooled = new SoapyRPCSocket();
+    pooled->swap(sock);
+
+    std::lock_guard<std::mutex> lock(getPoolMutex());
+    expireIdleConnections();
+    auto &conns = getIdleConnections()[url];
+    conns.push_back(IdleConnection{pooled, std::chrono::steady_clock::now() + std::chrono::microseconds(SOAPY_REMOTE_CONNECTION_TTL_US)});
+
+    //keep the most recent connections
+    if (conns.size() > SOAPY_REMOTE_CONNECTION_POOL_SIZE)
+    {
+        delete conns.front().sock;
+        conns.erase(conns.begin());
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <string>
+
+class SoapyRPCSocket;
+
+/*!
+ * A process-wide pool of idle server connections keyed by URL.
+ * Discovery, device make, and log acceptance take a connection
+ * from the pool and return it when no call is in progress,
+ * so repeated enumeration and make avoid new TCP handshakes.
+ *
+ * Idle connections expire after SOAPY_REMOTE_CONNECTION_TTL_US,
+ * and a connection is health checked before it is reused:
+ * any readable data or a pending socket error means the server
+ * closed the connection or it is out of sync, so it is discarded.
+ */
+class SoapyConnectionPool
+{
+public:
+    /*!
+     * Connect the socket to the server at the URL.
+     * Reuse a healthy idle connection or make a new connection.
+     * Return 0 for success or the error code from connect.
+     */
+    static int connect(SoapyRPCSocket &sock, const std::string &url, const long timeoutUs);
+
+    /*!
+     * Return a connection to the pool (the socket becomes null).
+     * Only release connections without a call in progress.
+     */
+    static void release(SoapyRPCSocket &sock, const std::string &url);
+};
@@ -5,6 +5,8 @@
 #include "SoapySSDPEndpoint.hpp"
 #include "SoapyMDNSEndpoint.hpp"
 #include "SoapyRemoteDefs.hpp"
+#include "SoapyURLUtils.hpp"
+#include "EnumerateCache.hpp"
 #include <memory>
 #include <future>
 #include <mutex>
@@ -77,5 +79,23 @@ std::vector<std::string> SoapyRemoteDevice::getServerURLs(const int ipVer, const
             serverUrls.push_back(uuidToMap.second.begin()->second);
         }
     }
+
+    //invalidate cached enumerations of servers that changed or left,
+    //the cache uses the URLs with the default scheme and service
+    const auto configIds = ssdpEndpoint->getServerConfigIds();
+    std::map<std::string, std::string> urlToConfigId;
+    for (const auto &uuidToMap : uuidToUrl)
+    {
+        const auto configIt = configIds.find(uuidToMap.first);
+        for (const auto &verToUrl : uuidToMap.second)
+        {
+            auto url = SoapyURL(verToUrl.second);
+            if (url.getScheme().empty()) url.setScheme("tcp");
+            if (url.getService().empty()) url.setService(SOAPY_REMOTE_DEFAULT_SERVICE);
+            urlToConfigId[url.toString()] = (configIt == configIds.end())?"":configIt->second;
+        }
+    }
+    SoapyEnumerateCache::updateServers(urlToConfigId);
+
     return serverUrls;
 }
@@ -0,0 +1,156 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnumerateCache.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Logger.hpp>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <list>
+
+/***********************************************************************
+ * cache storage
+ **********************************************************************/
+struct EnumerateCacheEntry
+{
+    EnumerateCacheEntry(void):
+        generation(0),
+        refreshing(false)
+    {
+        return;
+    }
+
+    SoapySDR::KwargsList result;
+    std::chrono::steady_clock::time_point fetched;
+    size_t generation; //of the server when fetched
+    bool refreshing;
+};
+
+struct EnumerateCacheData
+{
+    std::mutex mutex;
+
+    //results by server URL and then enumeration args
+    std::map<std::string, std::map<std::string, EnumerateCacheEntry>> entries;
+
+    //bumped when the server's results are invalidated
+    std::map<std::string, size_t> generations;
+
+    //last discovery state: configuration ID by server URL
+    std::map<std::string, std::string> discovered;
+
+    //background refreshes, the destructor waits on them
+    std::list<std::future<void>> refreshes;
+
+    void invalidate(const std::string &url)
+    {
+        generations[url]++;
+        entries.erase(url);
+    }
+
+    void reapRefreshes(void)
+    {
+        for (auto it = refreshes.begin(); it != refreshes.end();)
+        {
+            if (it->wait_for(std::chrono::seconds(0)) == std::future_status::ready) refreshes.erase(it++);
+            else ++it;
+        }
+    }
+};
+
+static EnumerateCacheData &getCacheData(void)
+{
+    static EnumerateCacheData data;
+    return data;
+}
+
+/***********************************************************************
+ * cache implementation
+ **********************************************************************/
+static void storeResult(const std::string &url, const std::string &key, const size_t generation, const SoapySDR::KwargsList &result)
+{
+    auto &data = getCacheData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    //drop results fetched before an invalidation
+    if (data.generations[url] != generation) return;
+    auto &entry = data.entries[url][key];
+    entry.result = result;
+    entry.fetched = std::chrono::steady_clock::now();
+    entry.generation = generation;
+    entry.refreshing = false;
+}
+
+static void refreshEntry(const std::string url, const std::string key, const size_t generation, const SoapyEnumerateCache::Fetch fetch)
+{
+    SoapySDR::KwargsList result;
+    if (fetch(result)) storeResult(url, key, generation, result);
+    else
+    {
+        //the server is gone, fetch again on the next call
+        auto &data = getCacheData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        if (data.generations[url] == generation) data.invalidate(url);
+    }
+}
+
+SoapySDR::KwargsList SoapyEnumerateCache::get(const std::string &url, const std::string &key, const long long freshUs, const Fetch &fetch)
+{
+    auto &data = getCacheData();
+    size_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(data.mutex);
+        data.reapRefreshes();
+        generation = data.generations[url];
+
+        auto &entries = data.entries[url];
+        const auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            auto &entry = it->second;
+            const auto age = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - entry.fetched).count();
+
+            //fresh results or a refresh already in progress
+            if (age < freshUs or (entry.refreshing and age < SOAPY_REMOTE_ENUMERATE_CACHE_MAX_AGE_US)) return entry.result;
+
+            //serve stale results while refreshing in the background
+            if (age < SOAPY_REMOTE_ENUMERATE_CACHE_MAX_AGE_US)
+            {
+                entry.refreshing = true;
+                data.refreshes.push_back(std::async(std::launch::async, &refreshEntry, url, key, generation, fetch));
+                return entry.result;
+            }
+        }
+    }
+
+    //nothing usable in the cache: fetch now, failures are not cached
+    SoapySDR::KwargsList result;
+    if (fetch(result)) storeResult(url, key, generation, result);
+    return result;
+}
+
+void SoapyEnumerateCache::updateServers(const std::map<std::string, std::string> &urlToConfigId)
+{
+    auto &data = getCacheData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    for (const auto &pair : data.discovered)
+    {
+        //the server left the discovered set
+        const auto it = urlToConfigId.find(pair.first);
+        if (it == urlToConfigId.end())
+        {
+            SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyEnumerateCache: %s no longer discovered", pair.first.c_str());
+            data.invalidate(pair.first);
+        }
+
+        //the server advertised a new configuration
+        else if (it->second != pair.second)
+        {
+            SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyEnumerateCache: %s configuration changed", pair.first.c_str());
+            data.invalidate(pair.first);
+        }
+    }
+    data.discovered = urlToConfigId;
+}
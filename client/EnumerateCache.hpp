@@ -0,0 +1,41 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <SoapySDR/Types.hpp>
+#include <functional>
+#include <string>
+#include <map>
+
+/*!
+ * A process-wide cache of the device lists returned by each server.
+ * Enumeration answers from memory: results younger than the fresh
+ * time are returned directly, older results are returned while
+ * a background refresh runs, and expired or missing results
+ * are fetched from the server in the calling thread.
+ *
+ * Discovery invalidates the results of a server when its advertised
+ * configuration ID changes or when the server leaves the discovered set
+ * (SSDP byebye, cache expiry, or mDNS service removal).
+ */
+class SoapyEnumerateCache
+{
+public:
+    //! Fetch the devices from the server, return false on failure
+    typedef std::function<bool(SoapySDR::KwargsList &)> Fetch;
+
+    /*!
+     * Get the device list for the server and enumeration args.
+     * \param url the server URL (used for invalidation)
+     * \param key the enumeration args that select the results
+     * \param freshUs the age in microseconds that needs no refresh
+     * \param fetch the function that queries the server
+     */
+    static SoapySDR::KwargsList get(const std::string &url, const std::string &key, const long long freshUs, const Fetch &fetch);
+
+    /*!
+     * Update the cache with the results of discovery.
+     * \param urlToConfigId the discovered server URLs to configuration IDs
+     */
+    static void updateServers(const std::map<std::string, std::string> &urlToConfigId);
+};
@@ -3,14 +3,17 @@
 
 #include "LogAcceptor.hpp"
 #include "SoapyRemoteDefs.hpp"
+#include "ConnectionPool.hpp"
 #include "SoapyRPCSocket.hpp"
 #include "SoapyRPCPacker.hpp"
 #include "SoapyRPCUnpacker.hpp"
 #include <SoapySDR/Logger.hpp>
 #include <csignal> //sig_atomic_t
 #include <cassert>
+#include <algorithm> //find
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <map>
 
 //timeout for the log polling loop before rechecking status
@@ -43,6 +46,7 @@ struct LogAcceptorThreadData
 
     SoapyRPCSocket client;
     std::string url;
+    SoapySDR::Kwargs args;
     long timeoutUs;
     sig_atomic_t done;
     std::thread *thread;
@@ -54,7 +58,7 @@ void LogAcceptorThreadData::activate(void)
     client = SoapyRPCSocket();
     //specify a timeout on connect because the link may be lost
     //when the thread attempts to re-establish a connection
-    int ret = client.connect(url, timeoutUs);
+    int ret = SoapyConnectionPool::connect(client, url, timeoutUs);
     if (ret != 0)
     {
         SoapySDR::logf(SOAPY_SDR_ERROR, "SoapyLogAcceptor::connect(%s) FAIL: %s", url.c_str(), client.lastErrorMsg());
@@ -67,6 +71,7 @@ void LogAcceptorThreadData::activate(void)
         //startup forwarding
         SoapyRPCPacker packerStart(client);
         packerStart & SOAPY_REMOTE_START_LOG_FORWARDING;
+        packerStart & args; //ignored by older servers
         packerStart();
         SoapyRPCUnpacker unpackerStart(client, true, timeoutUs);
         done = false;
@@ -158,10 +163,57 @@ static void threadMaintenance(void)
     }
 }
 
+/***********************************************************************
+ * log messages pushed on the control socket
+ **********************************************************************/
+static void handleLogPush(SoapyRPCUnpacker &unpacker)
+{
+    char logLevel = 0;
+    std::string message;
+    unpacker & logLevel;
+    unpacker & message;
+    SoapySDR::log(SoapySDR::LogLevel(logLevel), message);
+}
+
+//one pushing connection per unique server id, so that several
+//devices on one server do not log every message several times
+struct LogPushSubscribers
+{
+    LogPushSubscribers(void):
+        active(nullptr)
+    {
+        return;
+    }
+    SoapyLogAcceptor *active;
+    std::vector<SoapyLogAcceptor *> acceptors;
+};
+
+static std::map<std::string, LogPushSubscribers> pushSubscribers;
+
+//the log forwarding options from the device args
+static SoapySDR::Kwargs forwardingArgs(const SoapySDR::Kwargs &args)
+{
+    //the device args arrive with the remote prefix stripped
+    static const size_t offset = std::string(SOAPY_REMOTE_KWARG_PREFIX).size();
+    SoapySDR::Kwargs result;
+    for (const std::string key : {SOAPY_REMOTE_KWARG_LOG_QUEUE, SOAPY_REMOTE_KWARG_LOG_DROP})
+    {
+        const auto it = args.find(key.substr(offset));
+        if (it != args.end()) result[key] = it->second;
+    }
+    return result;
+}
+
 /***********************************************************************
  * client subscription hooks
  **********************************************************************/
-SoapyLogAcceptor::SoapyLogAcceptor(const std::string &url, SoapyRPCSocket &sock, const long timeoutUs)
+SoapyLogAcceptor::SoapyLogAcceptor(const std::string &url, SoapyRPCSocket &sock, const long timeoutUs,
+    const SoapySDR::Kwargs &args, std::mutex *sockMutex):
+    _sock(sock),
+    _sockMutex(sockMutex),
+    _push(false),
+    _timeoutUs(timeoutUs),
+    _args(forwardingArgs(args))
 {
     SoapyRPCPacker packer(sock);
     packer & SOAPY_REMOTE_GET_SERVER_ID;
@@ -169,11 +221,36 @@ SoapyLogAcceptor::SoapyLogAcceptor(const std::string &url, SoapyRPCSocket &sock,
     SoapyRPCUnpacker unpacker(sock, true, timeoutUs);
     unpacker & _serverId;
 
+    //newer servers push the log messages on this socket,
+    //the handler is ready before the first message can arrive,
+    //and only the first connection to the server subscribes
+    if (unpacker.remoteRPCVersion() >= SoapyRPCVersionLogPush)
+    {
+        _push = true;
+        SoapyRPCUnpacker::setPushHandler(sock, SOAPY_REMOTE_PUSH_LOG, &handleLogPush);
+        std::lock_guard<std::mutex> lock(logMutex);
+        auto &subscribers = pushSubscribers[_serverId];
+        if (subscribers.active == nullptr) try
+        {
+            this->startPush();
+            subscribers.active = this;
+        }
+        catch (...)
+        {
+            if (subscribers.acceptors.empty()) pushSubscribers.erase(_serverId);
+            SoapyRPCUnpacker::setPushHandler(sock, SOAPY_REMOTE_PUSH_LOG, SoapyRPCUnpacker::PushHandler());
+            throw;
+        }
+        subscribers.acceptors.push_back(this);
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(logMutex);
 
     auto &data = handlers[_serverId];
     data.useCount++;
     data.url = url;
+    for (const auto &pair : _args) data.args[pair.first] = pair.second;
     if (timeoutUs != 0) data.timeoutUs = timeoutUs;
 
     threadMaintenance();
@@ -181,6 +258,50 @@ SoapyLogAcceptor::SoapyLogAcceptor(const std::string &url, SoapyRPCSocket &sock,
 
 SoapyLogAcceptor::~SoapyLogAcceptor(void)
 {
+    //the server stops pushing when the device is released,
+    //otherwise stop forwarding before the connection is reused,
+    //messages that arrive before the reply are still handled
+    if (_push)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        auto &subscribers = pushSubscribers.at(_serverId);
+        subscribers.acceptors.erase(std::find(subscribers.acceptors.begin(), subscribers.acceptors.end(), this));
+        if (subscribers.active == this)
+        {
+            subscribers.active = nullptr;
+            if (not _sock.null()) try
+            {
+                this->stopPush();
+            }
+            catch (const std::exception &ex)
+            {
+                SoapySDR::logf(SOAPY_SDR_ERROR, "~SoapyLogAcceptor() FAIL: %s", ex.what());
+            }
+
+            //hand the subscription to another live device connection,
+            //connections without a socket mutex are in use by another thread
+            for (auto acceptor : subscribers.acceptors)
+            {
+                if (acceptor->_sockMutex == nullptr) continue;
+                std::lock_guard<std::mutex> sockLock(*acceptor->_sockMutex);
+                if (acceptor->_sock.null()) continue;
+                try
+                {
+                    acceptor->startPush();
+                    subscribers.active = acceptor;
+                    break;
+                }
+                catch (const std::exception &ex)
+                {
+                    SoapySDR::logf(SOAPY_SDR_ERROR, "~SoapyLogAcceptor() handover FAIL: %s", ex.what());
+                }
+            }
+        }
+        if (subscribers.acceptors.empty()) pushSubscribers.erase(_serverId);
+        SoapyRPCUnpacker::setPushHandler(_sock, SOAPY_REMOTE_PUSH_LOG, SoapyRPCUnpacker::PushHandler());
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(logMutex);
 
     auto &data = handlers.at(_serverId);
@@ -188,3 +309,20 @@ SoapyLogAcceptor::~SoapyLogAcceptor(void)
 
     threadMaintenance();
 }
+
+void SoapyLogAcceptor::startPush(void)
+{
+    SoapyRPCPacker packer(_sock);
+    packer & SOAPY_REMOTE_START_LOG_FORWARDING;
+    packer & _args;
+    packer();
+    SoapyRPCUnpacker unpacker(_sock, true, _timeoutUs);
+}
+
+void SoapyLogAcceptor::stopPush(void)
+{
+    SoapyRPCPacker packer(_sock);
+    packer & SOAPY_REMOTE_STOP_LOG_FORWARDING;
+    packer();
+    SoapyRPCUnpacker unpacker(_sock, true, _timeoutUs);
+}
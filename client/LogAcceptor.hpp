@@ -2,20 +2,37 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
+#include <SoapySDR/Types.hpp>
 #include <string>
+#include <mutex>
 
 class SoapyRPCSocket;
 
 /*!
  * Create a log acceptor to subscribe to log events from the remote server.
- * The acceptor avoids redundant threads by reference counting subscribers.
+ * Newer servers push the log messages on the device's control socket.
+ * One connection per server subscribes, and the subscription moves to another
+ * connection (locked by its socket mutex) when that acceptor is deleted.
+ * Forwarding stops when the device is released or the acceptor is deleted.
+ * For older servers, the acceptor connects to the server separately,
+ * and avoids redundant threads by reference counting subscribers.
+ * The log forwarding options in the args apply when forwarding starts.
  */
 class SoapyLogAcceptor
 {
 public:
-    SoapyLogAcceptor(const std::string &url, SoapyRPCSocket &sock, const long timeoutUs = 0);
+    SoapyLogAcceptor(const std::string &url, SoapyRPCSocket &sock, const long timeoutUs = 0,
+        const SoapySDR::Kwargs &args = SoapySDR::Kwargs(), std::mutex *sockMutex = nullptr);
     ~SoapyLogAcceptor(void);
 
 private:
+    void startPush(void);
+    void stopPush(void);
+
+    SoapyRPCSocket &_sock;
+    std::mutex *_sockMutex;
+    bool _push;
+    const long _timeoutUs;
+    SoapySDR::Kwargs _args;
     std::string _serverId;
 };
@@ -2,7 +2,10 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #include "SoapyClient.hpp"
+#include "SoapyCluster.hpp"
 #include "LogAcceptor.hpp"
+#include "ConnectionPool.hpp"
+#include "EnumerateCache.hpp"
 #include "SoapyURLUtils.hpp"
 #include "SoapyRemoteDefs.hpp"
 #include "SoapyRPCPacker.hpp"
@@ -10,6 +13,7 @@
 #include <SoapySDR/Registry.hpp>
 #include <SoapySDR/Logger.hpp>
 #include <future>
+#include <sstream>
 
 /***********************************************************************
  * Args translator for nested keywords
@@ -45,6 +49,76 @@ static SoapySDR::Kwargs translateArgs(const SoapySDR::Kwargs &args)
     return argsOut;
 }
 
+/***********************************************************************
+ * Find transaction with a specific server
+ **********************************************************************/
+static bool findRemoteURL(const SoapyURL &url, const SoapySDR::Kwargs &args, const long timeoutUs, SoapySDR::KwargsList &result)
+{
+    SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyClient querying devices for %s", url.toString().c_str());
+
+    //The first connection may be delayed by ARP, either on the client
+    //or the server side as previous communication was multi-casted.
+    //To be consistent with the normal specified timeout value,
+    //the first connection timeout is increased to compensate.
+    const long arpTimeout(SOAPY_REMOTE_SOCKET_TIMEOUT_US);
+
+    //try to connect to the remote server (or reuse an idle connection)
+    SoapySocketSession sess;
+    SoapyRPCSocket s;
+    int ret = SoapyConnectionPool::connect(s, url.toString(), timeoutUs+arpTimeout);
+    if (ret != 0)
+    {
+        SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyRemote::find() -- connect(%s) FAIL: %s", url.toString().c_str(), s.lastErrorMsg());
+        return false;
+    }
+
+    //find transaction
+    try
+    {
+        {
+            //No log forwarding during discovery unless debug build:
+            #ifndef NDEBUG
+            SoapyLogAcceptor logAcceptor(url.toString(), s, timeoutUs);
+            #endif //NDEBUG
+
+            SoapyRPCPacker packer(s);
+            packer & SOAPY_REMOTE_FIND;
+            packer & translateArgs(args);
+            packer();
+            SoapyRPCUnpacker unpacker(s);
+            unpacker & result;
+        }
+
+        //keep the connection for the next find or make,
+        //log forwarding stopped with the log acceptor
+        SoapyConnectionPool::release(s, url.toString());
+    }
+    catch (const std::exception &ex)
+    {
+        SoapySDR::logf(SOAPY_SDR_ERROR, "SoapyRemote::find(%s) -- transact FAIL: %s", url.toString().c_str(), ex.what());
+        return false;
+    }
+
+    //remove instances of the stop key from the result
+    for (auto &resultArgs : result)
+    {
+        resultArgs.erase(SOAPY_REMOTE_KWARG_STOP);
+        if (resultArgs.count("driver") != 0)
+        {
+            resultArgs["remote:driver"] = resultArgs.at("driver");
+            resultArgs.erase("driver");
+        }
+        if (resultArgs.count("type") != 0)
+        {
+            resultArgs["remote:type"] = resultArgs.at("type");
+            resultArgs.erase("type");
+        }
+        resultArgs["remote"] = url.toString();
+    }
+
+    return true;
+}
+
 /***********************************************************************
  * Discovery routine -- connect to server when key specified
  **********************************************************************/
@@ -54,6 +128,9 @@ static std::vector<SoapySDR::Kwargs> findRemote(const SoapySDR::Kwargs &args)
 
     if (args.count(SOAPY_REMOTE_KWARG_STOP) != 0) return result;
 
+    //cluster nodes are found by the cluster driver
+    if (args.count(SOAPY_REMOTE_KWARG_CLUSTER) != 0 and args.count("remote") == 0) return result;
+
     //extract timeout
     long timeoutUs = SOAPY_REMOTE_SOCKET_TIMEOUT_US;
     const auto timeoutIt = args.find("remote:timeout");
@@ -86,74 +163,37 @@ static std::vector<SoapySDR::Kwargs> findRemote(const SoapySDR::Kwargs &args)
         return result;
     }
 
-    //otherwise connect to a specific url and enumerate
+    //otherwise enumerate a specific url (through the cache)
     auto url = SoapyURL(args.at("remote"));
-    SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyClient querying devices for %s", url.toString().c_str());
 
     //default url parameters when not specified
     if (url.getScheme().empty()) url.setScheme("tcp");
     if (url.getService().empty()) url.setService(SOAPY_REMOTE_DEFAULT_SERVICE);
 
-    //The first connection may be delayed by ARP, either on the client
-    //or the server side as previous communication was multi-casted.
-    //To be consistent with the normal specified timeout value,
-    //the first connection timeout is increased to compensate.
-    const long arpTimeout(SOAPY_REMOTE_SOCKET_TIMEOUT_US);
-
-    //try to connect to the remote server
-    SoapySocketSession sess;
-    SoapyRPCSocket s;
-    int ret = s.connect(url.toString(), timeoutUs+arpTimeout);
-    if (ret != 0)
+    //extract the cache freshness, the key is not forwarded to the server
+    auto findArgs = args;
+    long long freshUs = SOAPY_REMOTE_ENUMERATE_CACHE_FRESH_US;
+    const auto cacheIt = findArgs.find("remote:cache");
+    if (cacheIt != findArgs.end())
     {
-        SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyRemote::find() -- connect(%s) FAIL: %s", url.toString().c_str(), s.lastErrorMsg());
-        return result;
+        freshUs = (long long)(std::stod(cacheIt->second)*1e6);
+        findArgs.erase(cacheIt);
     }
 
-    //find transaction
-    try
+    const auto fetch = [url, findArgs, timeoutUs](SoapySDR::KwargsList &result)
     {
-        //No log forwarding during discovery unless debug build:
-        #ifndef NDEBUG
-        SoapyLogAcceptor logAcceptor(url.toString(), s, timeoutUs);
-        #endif //NDEBUG
-
-        SoapyRPCPacker packer(s);
-        packer & SOAPY_REMOTE_FIND;
-        packer & translateArgs(args);
-        packer();
-        SoapyRPCUnpacker unpacker(s);
-        unpacker & result;
-
-        //graceful disconnect
-        SoapyRPCPacker packerHangup(s);
-        packerHangup & SOAPY_REMOTE_HANGUP;
-        packerHangup();
-        SoapyRPCUnpacker unpackerHangup(s);
-    }
-    catch (const std::exception &ex)
-    {
-        SoapySDR::logf(SOAPY_SDR_ERROR, "SoapyRemote::find(%s) -- transact FAIL: %s", url.toString().c_str(), ex.what());
-    }
-
-    //remove instances of the stop key from the result
-    for (auto &resultArgs : result)
+        return findRemoteURL(url, findArgs, timeoutUs, result);
+    };
+    if (freshUs <= 0)
     {
-        resultArgs.erase(SOAPY_REMOTE_KWARG_STOP);
-        if (resultArgs.count("driver") != 0)
-        {
-            resultArgs["remote:driver"] = resultArgs.at("driver");
-            resultArgs.erase("driver");
-        }
-        if (resultArgs.count("type") != 0)
-        {
-            resultArgs["remote:type"] = resultArgs.at("type");
-            resultArgs.erase("type");
-        }
-        resultArgs["remote"] = url.toString();
+        fetch(result);
+        return result;
     }
 
-    return result;
+    //the enumeration result depends on the args sent to the server
+    auto keyArgs = translateArgs(findArgs);
+    keyArgs.erase("timeout");
+    return SoapyEnumerateCache::get(url.toString(), SoapySDR::KwargsToString(keyArgs), freshUs, fetch);
 }
 
 /***********************************************************************
@@ -180,7 +220,98 @@ static SoapySDR::Device *makeRemote(const SoapySDR::Kwargs &args)
     return new SoapyRemoteDevice(url.toString(), translateArgs(args));
 }
 
+/***********************************************************************
+ * Cluster routines -- one remote device per URL combined into one device
+ **********************************************************************/
+static std::vector<std::string> clusterURLs(const SoapySDR::Kwargs &args)
+{
+    std::vector<std::string> urls;
+    std::istringstream iss(args.at(SOAPY_REMOTE_KWARG_CLUSTER));
+    std::string url;
+    while (iss >> url) urls.push_back(url);
+    return urls;
+}
+
+static SoapySDR::Kwargs clusterNodeArgs(const SoapySDR::Kwargs &args, const std::string &url)
+{
+    auto nodeArgs = args;
+    nodeArgs.erase(SOAPY_REMOTE_KWARG_CLUSTER);
+    nodeArgs["remote"] = url;
+    return nodeArgs;
+}
+
+static std::vector<SoapySDR::Kwargs> findCluster(const SoapySDR::Kwargs &args)
+{
+    std::vector<SoapySDR::Kwargs> result;
+
+    if (args.count(SOAPY_REMOTE_KWARG_STOP) != 0) return result;
+    if (args.count(SOAPY_REMOTE_KWARG_CLUSTER) == 0) return result;
+
+    //query the nodes in parallel, every node needs a device
+    const auto urls = clusterURLs(args);
+    std::vector<std::future<SoapySDR::KwargsList>> futures;
+    for (const auto &url : urls)
+    {
+        futures.push_back(std::async(std::launch::async, &findRemote, clusterNodeArgs(args, url)));
+    }
+    bool found = not urls.empty();
+    for (auto &future : futures) found = (not future.get().empty()) and found;
+    if (not found) return result;
+
+    auto clusterArgs = args;
+    clusterArgs.erase("driver");
+    clusterArgs["label"] = "SoapyRemote cluster of " + std::to_string(urls.size()) + " nodes";
+    result.push_back(clusterArgs);
+    return result;
+}
+
+static SoapySDR::Device *makeCluster(const SoapySDR::Kwargs &args)
+{
+    if (args.count(SOAPY_REMOTE_KWARG_CLUSTER) == 0)
+    {
+        throw std::runtime_error("SoapyRemoteCluster() -- missing " + std::string(SOAPY_REMOTE_KWARG_CLUSTER));
+    }
+
+    const auto urls = clusterURLs(args);
+    if (urls.empty())
+    {
+        throw std::runtime_error("SoapyRemoteCluster() -- no node URLs");
+    }
+
+    //make the nodes in parallel, release the others on errors
+    std::vector<std::future<SoapySDR::Device *>> futures;
+    for (const auto &url : urls)
+    {
+        futures.push_back(std::async(std::launch::async, &makeRemote, clusterNodeArgs(args, url)));
+    }
+    std::vector<SoapySDR::Device *> nodes;
+    std::string errorMsg;
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        try
+        {
+            nodes.push_back(futures[i].get());
+        }
+        catch (const std::exception &ex)
+        {
+            if (errorMsg.empty()) errorMsg = urls[i] + ": " + ex.what();
+        }
+    }
+
+    try
+    {
+        if (not errorMsg.empty()) throw std::runtime_error("SoapyRemoteCluster() -- node FAIL " + errorMsg);
+        return new SoapyRemoteCluster(nodes);
+    }
+    catch (...)
+    {
+        for (auto node : nodes) delete node;
+        throw;
+    }
+}
+
 /***********************************************************************
  * Registration
  **********************************************************************/
 static SoapySDR::Registry registerRemote("remote", &findRemote, &makeRemote, SOAPY_SDR_ABI_VERSION);
+static SoapySDR::Registry registerRemoteCluster("remotecluster", &findCluster, &makeCluster, SOAPY_SDR_ABI_VERSION);
@@ -4,6 +4,12 @@
 
 #include "SoapyClient.hpp"
 #include "LogAcceptor.hpp"
+#include "ConnectionPool.hpp"
+#include "SoapySocketPool.hpp"
+#include "ClientStatusChannel.hpp"
+#include "ClockModel.hpp"
+#include "ClientSubscriptions.hpp"
+#include "ClientPushReceiver.hpp"
 #include "SoapyRemoteDefs.hpp"
 #include "SoapyRPCPacker.hpp"
 #include "SoapyRPCUnpacker.hpp"
@@ -16,6 +22,12 @@
 
 SoapyRemoteDevice::SoapyRemoteDevice(const std::string &url, const SoapySDR::Kwargs &args):
     _logAcceptor(nullptr),
+    _socketPool(new SoapySocketPool(SOAPY_REMOTE_SOCKET_POOL_SIZE)),
+    _statusChannel(nullptr),
+    _clockModel(nullptr),
+    _subscriptions(nullptr),
+    _pushReceiver(nullptr),
+    _remoteRPCVersion(0),
     _defaultStreamProt("udp")
 {
     //extract timeout
@@ -23,52 +35,89 @@ SoapyRemoteDevice::SoapyRemoteDevice(const std::string &url, const SoapySDR::Kwa
     const auto timeoutIt = args.find("timeout");
     if (timeoutIt != args.end()) timeoutUs = std::stol(timeoutIt->second);
 
-    //try to connect to the remote server
-    int ret = _sock.connect(url, timeoutUs);
+    //try to connect to the remote server (or reuse an idle connection)
+    int ret = SoapyConnectionPool::connect(_sock, url, timeoutUs);
     if (ret != 0)
     {
         throw std::runtime_error("SoapyRemoteDevice("+url+") -- connect FAIL: " + _sock.lastErrorMsg());
     }
 
-    //connect the log acceptor
-    _logAcceptor = new SoapyLogAcceptor(url, _sock, timeoutUs);
+    //connect the log acceptor (or start pushed log messages)
+    _logAcceptor = new SoapyLogAcceptor(url, _sock, timeoutUs, args, &_mutex);
 
-    //acquire device instance
-    SoapyRPCPacker packer(_sock);
-    packer & SOAPY_REMOTE_MAKE;
-    packer & args;
-    packer();
-    SoapyRPCUnpacker unpacker(_sock);
+    //acquire device instance,
+    //dont leave a failed device in the log subscriptions
+    try
+    {
+        SoapyRPCPacker packer(_sock);
+        packer & SOAPY_REMOTE_MAKE;
+        packer & args;
+        packer();
+        SoapyRPCUnpacker unpacker(_sock);
+        _remoteRPCVersion = unpacker.remoteRPCVersion();
+    }
+    catch (...)
+    {
+        delete _logAcceptor;
+        throw;
+    }
+    _url = url;
+
+    //newer servers push log messages and subscribed values between calls
+    if (_remoteRPCVersion >= SoapyRPCVersionPush) _pushReceiver = new ClientPushReceiver(_sock, _mutex);
 
     //default stream protocol specified in device args
     const auto protIt = args.find("prot");
     if (protIt != args.end()) _defaultStreamProt = protIt->second;
+
+    //model the hardware clock to answer getHardwareTime() locally
+    const auto clockIt = args.find("clock");
+    if (clockIt != args.end())
+    {
+        long long toleranceNs = SOAPY_REMOTE_CLOCK_TOLERANCE_NS;
+        const auto toleranceIt = args.find("clock_tolerance");
+        if (toleranceIt != args.end()) toleranceNs = std::stoll(toleranceIt->second);
+        const long periodUs = long(std::stod(clockIt->second)*1e6);
+        _clockModel = new ClientClockModel([this]{return this->getHardwareTimeRPC("");}, periodUs, toleranceNs);
+    }
 }
 
 SoapyRemoteDevice::~SoapyRemoteDevice(void)
 {
-    //cant throw in the destructor
+    //stop sampling the clock and receiving pushes before the device goes away,
+    //pushes that arrive before the unmake reply are handled by its unpacker
+    delete _clockModel;
+    delete _pushReceiver;
+
+    //cant throw in the destructor,
+    //the lock keeps a log acceptor handover off the socket
     try
     {
         //release device instance
+        std::lock_guard<std::mutex> lock(_mutex);
         SoapyRPCPacker packer(_sock);
         packer & SOAPY_REMOTE_UNMAKE;
         packer();
         SoapyRPCUnpacker unpacker(_sock);
 
-        //graceful disconnect
-        SoapyRPCPacker packerHangup(_sock);
-        packerHangup & SOAPY_REMOTE_HANGUP;
-        packerHangup();
-        SoapyRPCUnpacker unpackerHangup(_sock);
+        //keep the connection for the next find or make
+        SoapyConnectionPool::release(_sock, _url);
     }
     catch (const std::exception &ex)
     {
         SoapySDR::logf(SOAPY_SDR_ERROR, "~SoapyRemoteDevice() FAIL: %s", ex.what());
     }
 
+    //the server pushes sensor values until it handles the unmake,
+    //so the push handler stays registered until the reply is in
+    delete _subscriptions.load();
+
     //disconnect the log acceptor (does not throw)
     delete _logAcceptor;
+
+    //close the pooled stream sockets and the status channel
+    delete _socketPool;
+    delete _statusChannel;
 }
 
 /*******************************************************************
@@ -915,6 +964,7 @@ void SoapyRemoteDevice::setTimeSource(const std::string &source)
     packer();
 
     SoapyRPCUnpacker unpacker(_sock);
+    if (_clockModel != nullptr) _clockModel->reset();
 }
 
 std::string SoapyRemoteDevice::getTimeSource(void) const
@@ -945,6 +995,18 @@ bool SoapyRemoteDevice::hasHardwareTime(const std::string &what) const
 }
 
 long long SoapyRemoteDevice::getHardwareTime(const std::string &what) const
+{
+    //answer from the clock model while its error is within tolerance
+    long long timeNs = 0;
+    if (what.empty() and _clockModel != nullptr and _clockModel->get(timeNs)) return timeNs;
+
+    //or from the pushed time when subscribed
+    auto subscriptions = _subscriptions.load();
+    if (what.empty() and subscriptions != nullptr and subscriptions->getTime(timeNs)) return timeNs;
+    return this->getHardwareTimeRPC(what);
+}
+
+long long SoapyRemoteDevice::getHardwareTimeRPC(const std::string &what) const
 {
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
@@ -968,6 +1030,7 @@ void SoapyRemoteDevice::setHardwareTime(const long long timeNs, const std::strin
     packer();
 
     SoapyRPCUnpacker unpacker(_sock);
+    if (_clockModel != nullptr) _clockModel->reset();
 }
 
 void SoapyRemoteDevice::setCommandTime(const long long timeNs, const std::string &what)
@@ -1015,6 +1078,11 @@ SoapySDR::ArgInfo SoapyRemoteDevice::getSensorInfo(const std::string &name) cons
 
 std::string SoapyRemoteDevice::readSensor(const std::string &name) const
 {
+    //answer from a fresh pushed value when subscribed
+    std::string result;
+    auto subscriptions = _subscriptions.load();
+    if (subscriptions != nullptr and subscriptions->get(name, 0, -1, result)) return result;
+
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
     packer & SOAPY_REMOTE_READ_SENSOR;
@@ -1022,7 +1090,6 @@ std::string SoapyRemoteDevice::readSensor(const std::string &name) const
     packer();
 
     SoapyRPCUnpacker unpacker(_sock);
-    std::string result;
     unpacker & result;
     return result;
 }
@@ -1060,6 +1127,11 @@ SoapySDR::ArgInfo SoapyRemoteDevice::getSensorInfo(const int direction, const si
 
 std::string SoapyRemoteDevice::readSensor(const int direction, const size_t channel, const std::string &name) const
 {
+    //answer from a fresh pushed value when subscribed
+    std::string result;
+    auto subscriptions = _subscriptions.load();
+    if (subscriptions != nullptr and subscriptions->get(name, direction, int(channel), result)) return result;
+
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
     packer & SOAPY_REMOTE_READ_CHANNEL_SENSOR;
@@ -1069,7 +1141,6 @@ std::string SoapyRemoteDevice::readSensor(const int direction, const size_t chan
     packer();
 
     SoapyRPCUnpacker unpacker(_sock);
-    std::string result;
     unpacker & result;
     return result;
 }
@@ -1195,6 +1266,11 @@ SoapySDR::ArgInfoList SoapyRemoteDevice::getSettingInfo(void) const
 
 void SoapyRemoteDevice::writeSetting(const std::string &key, const std::string &value)
 {
+    //sensor and time subscriptions are handled by SoapyRemote
+    static const std::string subscribePrefix(SOAPY_REMOTE_KWARG_SUBSCRIBE);
+    if (key == SOAPY_REMOTE_KWARG_SUBSCRIBE_TIME) return this->subscribe(key, 0, -1, value);
+    if (key.find(subscribePrefix) == 0) return this->subscribe(key.substr(subscribePrefix.size()), 0, -1, value);
+
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
     packer & SOAPY_REMOTE_WRITE_SETTING;
@@ -1205,6 +1281,31 @@ void SoapyRemoteDevice::writeSetting(const std::string &key, const std::string &
     SoapyRPCUnpacker unpacker(_sock);
 }
 
+void SoapyRemoteDevice::subscribe(const std::string &what, const int direction, const int channel, const std::string &period)
+{
+    if (_remoteRPCVersion < SoapyRPCVersionPush)
+    {
+        throw std::runtime_error("SoapyRemote::writeSetting() -- server does not support subscriptions");
+    }
+
+    //the value is the push period in seconds, empty or zero to unsubscribe
+    const double periodSec = period.empty()?0.0:std::stod(period);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_subscriptions == nullptr) _subscriptions = new ClientSubscriptions(_sock);
+    _subscriptions.load()->setPeriod(what, direction, channel, (long long)(periodSec*1e6));
+
+    SoapyRPCPacker packer(_sock);
+    packer & SOAPY_REMOTE_SUBSCRIBE;
+    packer & what;
+    packer & char(direction);
+    packer & channel;
+    packer & periodSec;
+    packer();
+
+    SoapyRPCUnpacker unpacker(_sock);
+}
+
 std::string SoapyRemoteDevice::readSetting(const std::string &key) const
 {
     std::lock_guard<std::mutex> lock(_mutex);
@@ -1221,21 +1322,92 @@ std::string SoapyRemoteDevice::readSetting(const std::string &key) const
 
 SoapySDR::ArgInfoList SoapyRemoteDevice::getSettingInfo(const int direction, const size_t channel) const
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    SoapyRPCPacker packer(_sock);
-    packer & SOAPY_REMOTE_GET_CHANNEL_SETTING_INFO;
-    packer & char(direction);
-    packer & int(channel);
-    packer();
-
-    SoapyRPCUnpacker unpacker(_sock);
     SoapySDR::ArgInfoList result;
-    unpacker & result;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        SoapyRPCPacker packer(_sock);
+        packer & SOAPY_REMOTE_GET_CHANNEL_SETTING_INFO;
+        packer & char(direction);
+        packer & int(channel);
+        packer();
+
+        SoapyRPCUnpacker unpacker(_sock);
+        unpacker & result;
+    }
+
+    //insert SoapyRemote channel settings
+    if (direction == SOAPY_SDR_RX)
+    {
+        SoapySDR::ArgInfo recordArg;
+        recordArg.key = SOAPY_REMOTE_KWARG_RECORD;
+        recordArg.name = "Remote Record";
+        recordArg.description = "Record the channel's receive stream to a SigMF file on the server; "
+            "write an empty path to stop, read for recording statistics.";
+        recordArg.type = SoapySDR::ArgInfo::STRING;
+        result.push_back(recordArg);
+    }
+
+    if (direction == SOAPY_SDR_TX)
+    {
+        SoapySDR::ArgInfo playArg;
+        playArg.key = SOAPY_REMOTE_KWARG_PLAY;
+        playArg.name = "Remote Play";
+        playArg.description = "Play a waveform cached on the server (name=waveform, repeat=count or 0 to loop, time=ns); "
+            "write an empty value to stop after the current repetition.";
+        playArg.type = SoapySDR::ArgInfo::STRING;
+        result.push_back(playArg);
+    }
+
     return result;
 }
 
 void SoapyRemoteDevice::writeSetting(const int direction, const size_t channel, const std::string &key, const std::string &value)
 {
+    //channel sensor subscriptions are handled by SoapyRemote
+    static const std::string subscribePrefix(SOAPY_REMOTE_KWARG_SUBSCRIBE);
+    if (key.find(subscribePrefix) == 0) return this->subscribe(key.substr(subscribePrefix.size()), direction, int(channel), value);
+
+    //server-side recording is handled by SoapyRemote
+    if (key == SOAPY_REMOTE_KWARG_RECORD)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        SoapyRPCPacker packer(_sock);
+        packer & (value.empty()?SOAPY_REMOTE_STOP_RECORDING:SOAPY_REMOTE_START_RECORDING);
+        packer & char(direction);
+        packer & int(channel);
+        if (not value.empty()) packer & value;
+        packer();
+
+        SoapyRPCUnpacker unpacker(_sock);
+        return;
+    }
+
+    //cached waveform playback is handled by SoapyRemote
+    if (key == SOAPY_REMOTE_KWARG_PLAY)
+    {
+        const auto playArgs = SoapySDR::KwargsFromString(value);
+        const auto nameIt = playArgs.find("name");
+        const auto repeatIt = playArgs.find("repeat");
+        const auto timeIt = playArgs.find("time");
+        const int repeat = (repeatIt == playArgs.end())?1:std::stoi(repeatIt->second);
+        const int flags = (timeIt == playArgs.end())?0:SOAPY_SDR_HAS_TIME;
+        const long long timeNs = (timeIt == playArgs.end())?0:std::stoll(timeIt->second);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        SoapyRPCPacker packer(_sock);
+        packer & SOAPY_REMOTE_PLAY_WAVEFORM;
+        packer & char(direction);
+        packer & int(channel);
+        packer & ((nameIt == playArgs.end())?std::string():nameIt->second);
+        packer & repeat;
+        packer & flags;
+        packer & timeNs;
+        packer();
+
+        SoapyRPCUnpacker unpacker(_sock);
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
     packer & SOAPY_REMOTE_WRITE_CHANNEL_SETTING;
@@ -1250,6 +1422,22 @@ void SoapyRemoteDevice::writeSetting(const int direction, const size_t channel,
 
 std::string SoapyRemoteDevice::readSetting(const int direction, const size_t channel, const std::string &key) const
 {
+    //server-side recording statistics as a markup string
+    if (key == SOAPY_REMOTE_KWARG_RECORD)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        SoapyRPCPacker packer(_sock);
+        packer & SOAPY_REMOTE_GET_RECORDING_STATUS;
+        packer & char(direction);
+        packer & int(channel);
+        packer();
+
+        SoapyRPCUnpacker unpacker(_sock);
+        SoapySDR::Kwargs result;
+        unpacker & result;
+        return SoapySDR::KwargsToString(result);
+    }
+
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
     packer & SOAPY_REMOTE_READ_CHANNEL_SETTING;
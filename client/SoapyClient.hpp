@@ -6,8 +6,15 @@
 #include "SoapyRPCSocket.hpp"
 #include <SoapySDR/Device.hpp>
 #include <mutex>
+#include <atomic>
 
 class SoapyLogAcceptor;
+class SoapySocketPool;
+class ClientStatusChannel;
+class ClientClockModel;
+class ClientSubscriptions;
+class ClientPushReceiver;
+struct ClientStreamData;
 
 class SoapyRemoteDevice : public SoapySDR::Device
 {
@@ -365,9 +372,20 @@ public:
     std::string readUART(const std::string &which, const long timeoutUs) const;
 
 private:
+    void uploadWaveform(ClientStreamData *data);
+    long long getHardwareTimeRPC(const std::string &what) const;
+    void subscribe(const std::string &what, const int direction, const int channel, const std::string &period);
+
     SoapySocketSession _sess;
     mutable SoapyRPCSocket _sock;
     SoapyLogAcceptor *_logAcceptor;
+    SoapySocketPool *_socketPool;
+    ClientStatusChannel *_statusChannel;
+    ClientClockModel *_clockModel;
+    std::atomic<ClientSubscriptions *> _subscriptions;
+    ClientPushReceiver *_pushReceiver;
     mutable std::mutex _mutex;
+    unsigned int _remoteRPCVersion;
+    std::string _url;
     std::string _defaultStreamProt;
 };
@@ -0,0 +1,953 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "SoapyCluster.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm> //min, max
+#include <stdexcept>
+#include <future>
+#include <chrono>
+#include <cstring> //memcpy
+#include <cstdlib> //llabs
+#include <cmath> //llround
+
+//call the function for each index in parallel, rethrow the first error
+template <typename Fn>
+static void parallelFor(const size_t num, const Fn &fn)
+{
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < num; i++) futures.push_back(std::async(std::launch::async, fn, i));
+    for (auto &future : futures) future.wait();
+    for (auto &future : futures) future.get();
+}
+
+/*******************************************************************
+ * Cluster stream data
+ ******************************************************************/
+struct ClusterNodeStream
+{
+    ClusterNodeStream(void):
+        device(nullptr),
+        stream(nullptr),
+        rate(0.0),
+        numPending(0),
+        hasTime(false),
+        baseTimeNs(0),
+        baseOffset(0),
+        numWritten(0)
+    {
+        return;
+    }
+
+    //the time of the first pending sample
+    long long pendingTimeNs(void) const
+    {
+        return baseTimeNs + std::llround(baseOffset*(1e9/rate));
+    }
+
+    void consume(const size_t numElems, const size_t elemSize)
+    {
+        for (auto &buff : pending) buff.erase(buff.begin(), buff.begin()+numElems*elemSize);
+        numPending -= numElems;
+        baseOffset += numElems;
+    }
+
+    void reset(void)
+    {
+        for (auto &buff : pending) buff.clear();
+        numPending = 0;
+        hasTime = false;
+        numWritten = 0;
+    }
+
+    SoapySDR::Device *device;
+    SoapySDR::Stream *stream;
+    std::vector<size_t> channels; //node channels in the node stream
+    std::vector<size_t> positions; //stream index of each node channel
+    double rate;
+
+    //received samples that are not returned yet
+    std::vector<std::vector<char>> pending;
+    size_t numPending;
+    bool hasTime;
+    long long baseTimeNs;
+    long long baseOffset; //samples since the base time
+
+    //samples of the caller's transmit buffer that this node already took
+    size_t numWritten;
+};
+
+struct ClusterStream
+{
+    int direction;
+    size_t elemSize;
+    std::vector<ClusterNodeStream> nodes;
+};
+
+/*******************************************************************
+ * Constructor
+ ******************************************************************/
+SoapyRemoteCluster::SoapyRemoteCluster(const std::vector<SoapySDR::Device *> &nodes):
+    _nodes(nodes)
+{
+    for (const int direction : {SOAPY_SDR_TX, SOAPY_SDR_RX})
+    {
+        for (size_t node = 0; node < _nodes.size(); node++)
+        {
+            const size_t numChans = _nodes[node]->getNumChannels(direction);
+            for (size_t channel = 0; channel < numChans; channel++)
+            {
+                Channel ch;
+                ch.node = node;
+                ch.channel = channel;
+                _channels[direction].push_back(ch);
+            }
+        }
+    }
+}
+
+SoapyRemoteCluster::~SoapyRemoteCluster(void)
+{
+    parallelFor(_nodes.size(), [this](const size_t i){delete _nodes[i];});
+}
+
+SoapySDR::Device *SoapyRemoteCluster::getNode(const int direction, const size_t channel, size_t &nodeChannel) const
+{
+    if (direction != SOAPY_SDR_TX and direction != SOAPY_SDR_RX)
+    {
+        throw std::runtime_error("SoapyRemoteCluster -- unknown direction "+std::to_string(direction));
+    }
+    const auto &channels = _channels[direction];
+    if (channel >= channels.size())
+    {
+        throw std::runtime_error("SoapyRemoteCluster -- channel "+std::to_string(channel)+" out of range");
+    }
+    nodeChannel = channels[channel].channel;
+    return _nodes[channels[channel].node];
+}
+
+SoapySDR::Device *SoapyRemoteCluster::getNode(const std::string &name, std::string &nodeName) const
+{
+    const auto sep = name.find(':');
+    if (name.compare(0, 4, "node") != 0 or sep == std::string::npos)
+    {
+        throw std::runtime_error("SoapyRemoteCluster -- expected node<index>:<name>, got "+name);
+    }
+    const size_t node = std::stoul(name.substr(4, sep-4));
+    if (node >= _nodes.size())
+    {
+        throw std::runtime_error("SoapyRemoteCluster -- node "+std::to_string(node)+" out of range");
+    }
+    nodeName = name.substr(sep+1);
+    return _nodes[node];
+}
+
+/*******************************************************************
+ * Identification API
+ ******************************************************************/
+
+std::string SoapyRemoteCluster::getDriverKey(void) const
+{
+    return "remotecluster";
+}
+
+std::string SoapyRemoteCluster::getHardwareKey(void) const
+{
+    std::string result;
+    for (const auto node : _nodes)
+    {
+        if (not result.empty()) result += ", ";
+        result += node->getHardwareKey();
+    }
+    return result;
+}
+
+SoapySDR::Kwargs SoapyRemoteCluster::getHardwareInfo(void) const
+{
+    SoapySDR::Kwargs result;
+    for (size_t i = 0; i < _nodes.size(); i++)
+    {
+        const std::string prefix = "node" + std::to_string(i) + ":";
+        result[prefix + "driver"] = _nodes[i]->getDriverKey();
+        for (const auto &pair : _nodes[i]->getHardwareInfo()) result[prefix + pair.first] = pair.second;
+    }
+    return result;
+}
+
+/*******************************************************************
+ * Channels API
+ ******************************************************************/
+
+size_t SoapyRemoteCluster::getNumChannels(const int direction) const
+{
+    if (direction != SOAPY_SDR_TX and direction != SOAPY_SDR_RX) return 0;
+    return _channels[direction].size();
+}
+
+SoapySDR::Kwargs SoapyRemoteCluster::getChannelInfo(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    auto result = this->getNode(direction, channel, nodeChannel)->getChannelInfo(direction, nodeChannel);
+    result["node"] = std::to_string(_channels[direction][channel].node);
+    result["node_channel"] = std::to_string(nodeChannel);
+    return result;
+}
+
+bool SoapyRemoteCluster::getFullDuplex(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFullDuplex(direction, nodeChannel);
+}
+
+/*******************************************************************
+ * Stream API
+ ******************************************************************/
+
+std::vector<std::string> SoapyRemoteCluster::getStreamFormats(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getStreamFormats(direction, nodeChannel);
+}
+
+std::string SoapyRemoteCluster::getNativeStreamFormat(const int direction, const size_t channel, double &fullScale) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getNativeStreamFormat(direction, nodeChannel, fullScale);
+}
+
+SoapySDR::ArgInfoList SoapyRemoteCluster::getStreamArgsInfo(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getStreamArgsInfo(direction, nodeChannel);
+}
+
+SoapySDR::Stream *SoapyRemoteCluster::setupStream(
+    const int direction,
+    const std::string &format,
+    const std::vector<size_t> &channels_,
+    const SoapySDR::Kwargs &args)
+{
+    //default to channel 0, if none were specified
+    const std::vector<size_t> &channels = channels_.empty() ? std::vector<size_t>{0} : channels_;
+
+    //group the channels by node in the order of the stream
+    std::vector<ClusterNodeStream> nodeStreams(_nodes.size());
+    for (size_t i = 0; i < channels.size(); i++)
+    {
+        size_t nodeChannel = 0;
+        this->getNode(direction, channels[i], nodeChannel);
+        auto &nodeStream = nodeStreams[_channels[direction][channels[i]].node];
+        nodeStream.channels.push_back(nodeChannel);
+        nodeStream.positions.push_back(i);
+    }
+
+    auto data = new ClusterStream();
+    data->direction = direction;
+    data->elemSize = SoapySDR::formatToSize(format);
+    for (size_t node = 0; node < _nodes.size(); node++)
+    {
+        auto &nodeStream = nodeStreams[node];
+        if (nodeStream.channels.empty()) continue;
+        nodeStream.device = _nodes[node];
+        nodeStream.pending.resize(nodeStream.channels.size());
+        data->nodes.push_back(nodeStream);
+    }
+
+    //open the node streams in parallel, close the others on error
+    try
+    {
+        parallelFor(data->nodes.size(), [&](const size_t i)
+        {
+            auto &nodeStream = data->nodes[i];
+            nodeStream.stream = nodeStream.device->setupStream(direction, format, nodeStream.channels, args);
+        });
+    }
+    catch (...)
+    {
+        for (auto &nodeStream : data->nodes)
+        {
+            if (nodeStream.stream != nullptr) nodeStream.device->closeStream(nodeStream.stream);
+        }
+        delete data;
+        throw;
+    }
+
+    return (SoapySDR::Stream *)data;
+}
+
+void SoapyRemoteCluster::closeStream(SoapySDR::Stream *stream)
+{
+    auto data = (ClusterStream *)stream;
+    parallelFor(data->nodes.size(), [data](const size_t i)
+    {
+        auto &nodeStream = data->nodes[i];
+        nodeStream.device->closeStream(nodeStream.stream);
+    });
+    delete data;
+}
+
+size_t SoapyRemoteCluster::getStreamMTU(SoapySDR::Stream *stream) const
+{
+    auto data = (ClusterStream *)stream;
+    size_t mtu = 0;
+    for (const auto &nodeStream : data->nodes)
+    {
+        const size_t nodeMtu = nodeStream.device->getStreamMTU(nodeStream.stream);
+        mtu = (mtu == 0)?nodeMtu:std::min(mtu, nodeMtu);
+    }
+    return mtu;
+}
+
+int SoapyRemoteCluster::activateStream(
+    SoapySDR::Stream *stream,
+    const int flags,
+    const long long timeNs,
+    const size_t numElems)
+{
+    auto data = (ClusterStream *)stream;
+    std::vector<int> results(data->nodes.size(), 0);
+    parallelFor(data->nodes.size(), [&](const size_t i)
+    {
+        auto &nodeStream = data->nodes[i];
+        nodeStream.reset();
+        nodeStream.rate = nodeStream.device->getSampleRate(data->direction, nodeStream.channels.front());
+        results[i] = nodeStream.device->activateStream(nodeStream.stream, flags, timeNs, numElems);
+    });
+    for (const auto result : results) if (result != 0) return result;
+    return 0;
+}
+
+int SoapyRemoteCluster::deactivateStream(
+    SoapySDR::Stream *stream,
+    const int flags,
+    const long long timeNs)
+{
+    auto data = (ClusterStream *)stream;
+    std::vector<int> results(data->nodes.size(), 0);
+    parallelFor(data->nodes.size(), [&](const size_t i)
+    {
+        auto &nodeStream = data->nodes[i];
+        results[i] = nodeStream.device->deactivateStream(nodeStream.stream, flags, timeNs);
+    });
+    for (const auto result : results) if (result != 0) return result;
+    return 0;
+}
+
+int SoapyRemoteCluster::readStream(
+    SoapySDR::Stream *stream,
+    void * const *buffs,
+    const size_t numElems,
+    int &flags,
+    long long &timeNs,
+    const long timeoutUs)
+{
+    auto data = (ClusterStream *)stream;
+    const size_t elemSize = data->elemSize;
+    const auto resetAll = [data]{for (auto &nodeStream : data->nodes) nodeStream.reset();};
+
+    //the nodes share one deadline for the whole call
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+    const auto remainingUs = [&deadline]
+    {
+        const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+        return long(std::max<long long>(remaining.count(), 0));
+    };
+
+    while (true)
+    {
+        //read more from each node that is short of the request
+        for (auto &nodeStream : data->nodes)
+        {
+            if (nodeStream.numPending >= numElems) continue;
+            const size_t numRead = numElems - nodeStream.numPending;
+            std::vector<void *> nodeBuffs;
+            for (auto &buff : nodeStream.pending)
+            {
+                buff.resize((nodeStream.numPending + numRead)*elemSize);
+                nodeBuffs.push_back(buff.data() + nodeStream.numPending*elemSize);
+            }
+
+            int nodeFlags = 0;
+            long long nodeTimeNs = 0;
+            const int ret = nodeStream.device->readStream(nodeStream.stream, nodeBuffs.data(), numRead, nodeFlags, nodeTimeNs, remainingUs());
+            for (auto &buff : nodeStream.pending) buff.resize((nodeStream.numPending + std::max(ret, 0))*elemSize);
+            if (ret == 0 or ret == SOAPY_SDR_TIMEOUT) return SOAPY_SDR_TIMEOUT;
+            if (ret < 0)
+            {
+                //overflows and other errors drop the partial alignment
+                resetAll();
+                return ret;
+            }
+
+            //the samples start over when they do not continue the pending samples
+            const bool hasTime = (nodeFlags & SOAPY_SDR_HAS_TIME) != 0;
+            if (hasTime and nodeStream.rate > 0.0)
+            {
+                const long long expectedNs = nodeStream.baseTimeNs + std::llround((nodeStream.baseOffset + nodeStream.numPending)*(1e9/nodeStream.rate));
+                if (not nodeStream.hasTime or nodeStream.numPending == 0 or std::llabs(nodeTimeNs - expectedNs)*nodeStream.rate > 0.5e9)
+                {
+                    if (nodeStream.numPending != 0) nodeStream.consume(nodeStream.numPending, elemSize);
+                    nodeStream.hasTime = true;
+                    nodeStream.baseTimeNs = nodeTimeNs;
+                    nodeStream.baseOffset = 0;
+                }
+            }
+            else nodeStream.hasTime = false;
+            nodeStream.numPending += ret;
+        }
+
+        //align the nodes on the latest first sample time
+        bool aligned = true;
+        long long alignTimeNs = 0;
+        for (const auto &nodeStream : data->nodes) aligned = aligned and nodeStream.hasTime;
+        if (aligned)
+        {
+            long long firstTimeNs = data->nodes.front().pendingTimeNs();
+            alignTimeNs = firstTimeNs;
+            for (const auto &nodeStream : data->nodes)
+            {
+                firstTimeNs = std::min(firstTimeNs, nodeStream.pendingTimeNs());
+                alignTimeNs = std::max(alignTimeNs, nodeStream.pendingTimeNs());
+            }
+            if (alignTimeNs - firstTimeNs > SOAPY_REMOTE_CLUSTER_MAX_SKEW_NS)
+            {
+                SoapySDR::logf(SOAPY_SDR_ERROR, "SoapyRemoteCluster::readStream() -- node times differ by %lld ns", alignTimeNs - firstTimeNs);
+                resetAll();
+                return SOAPY_SDR_TIME_ERROR;
+            }
+
+            //drop the samples before the aligned time, read again when a node runs out
+            bool drained = false;
+            for (auto &nodeStream : data->nodes)
+            {
+                const long long skip = std::llround((alignTimeNs - nodeStream.pendingTimeNs())*(nodeStream.rate/1e9));
+                nodeStream.consume(std::min<size_t>(size_t(std::max(skip, 0LL)), nodeStream.numPending), elemSize);
+                drained = drained or nodeStream.numPending == 0;
+            }
+            if (drained and remainingUs() == 0) return SOAPY_SDR_TIMEOUT;
+            if (drained) continue;
+        }
+
+        //return the samples that every node has
+        size_t numOut = numElems;
+        for (const auto &nodeStream : data->nodes) numOut = std::min(numOut, nodeStream.numPending);
+        for (auto &nodeStream : data->nodes)
+        {
+            for (size_t i = 0; i < nodeStream.positions.size(); i++)
+            {
+                std::memcpy(buffs[nodeStream.positions[i]], nodeStream.pending[i].data(), numOut*elemSize);
+            }
+            nodeStream.consume(numOut, elemSize);
+        }
+        flags = aligned?SOAPY_SDR_HAS_TIME:0;
+        timeNs = alignTimeNs;
+        return int(numOut);
+    }
+}
+
+int SoapyRemoteCluster::writeStream(
+    SoapySDR::Stream *stream,
+    const void * const *buffs,
+    const size_t numElems,
+    int &flags,
+    const long long timeNs,
+    const long timeoutUs)
+{
+    auto data = (ClusterStream *)stream;
+
+    //every node sends the whole buffer so the nodes stay aligned,
+    //a node resumes from the samples it took in a previous call,
+    //only the first write of each node carries the time;
+    //a timed write starts a new burst and drops the previous progress
+    if ((flags & SOAPY_SDR_HAS_TIME) != 0)
+    {
+        for (auto &nodeStream : data->nodes) nodeStream.numWritten = 0;
+    }
+    int error = 0;
+    for (auto &nodeStream : data->nodes)
+    {
+        while (nodeStream.numWritten < numElems)
+        {
+            std::vector<const void *> nodeBuffs;
+            for (const auto pos : nodeStream.positions)
+            {
+                nodeBuffs.push_back((const char *)buffs[pos] + nodeStream.numWritten*data->elemSize);
+            }
+            int nodeFlags = (nodeStream.numWritten == 0)?flags:(flags & ~SOAPY_SDR_HAS_TIME);
+            const int ret = nodeStream.device->writeStream(nodeStream.stream, nodeBuffs.data(), numElems-nodeStream.numWritten, nodeFlags, timeNs, timeoutUs);
+            if (ret < 0 and error == 0) error = ret;
+            if (ret <= 0) break;
+            nodeStream.numWritten += ret;
+        }
+    }
+
+    //only the samples that every node took are consumed,
+    //the caller passes the rest again and each node skips what it sent,
+    //but a caller usually drops the buffer after an error (not a timeout)
+    size_t numSent = numElems;
+    for (const auto &nodeStream : data->nodes) numSent = std::min(numSent, nodeStream.numWritten);
+    if (numSent == 0)
+    {
+        if (error != SOAPY_SDR_TIMEOUT) for (auto &nodeStream : data->nodes) nodeStream.numWritten = 0;
+        return error;
+    }
+    for (auto &nodeStream : data->nodes) nodeStream.numWritten -= numSent;
+    return int(numSent);
+}
+
+int SoapyRemoteCluster::readStreamStatus(
+    SoapySDR::Stream *stream,
+    size_t &chanMask,
+    int &flags,
+    long long &timeNs,
+    const long timeoutUs)
+{
+    auto data = (ClusterStream *)stream;
+
+    //poll each node with a share of the timeout
+    const long nodeTimeoutUs = timeoutUs/long(data->nodes.size());
+    for (auto &nodeStream : data->nodes)
+    {
+        size_t nodeMask = 0;
+        const int ret = nodeStream.device->readStreamStatus(nodeStream.stream, nodeMask, flags, timeNs, nodeTimeoutUs);
+        if (ret == SOAPY_SDR_TIMEOUT or ret == SOAPY_SDR_NOT_SUPPORTED) continue;
+
+        //the node channel mask in terms of the stream channels
+        chanMask = 0;
+        for (size_t i = 0; i < nodeStream.positions.size(); i++)
+        {
+            if ((nodeMask & (size_t(1) << i)) != 0) chanMask |= size_t(1) << nodeStream.positions[i];
+        }
+        return ret;
+    }
+    return SOAPY_SDR_TIMEOUT;
+}
+
+/*******************************************************************
+ * Antenna API
+ ******************************************************************/
+
+std::vector<std::string> SoapyRemoteCluster::listAntennas(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->listAntennas(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setAntenna(const int direction, const size_t channel, const std::string &name)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setAntenna(direction, nodeChannel, name);
+}
+
+std::string SoapyRemoteCluster::getAntenna(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getAntenna(direction, nodeChannel);
+}
+
+/*******************************************************************
+ * Frontend corrections API
+ ******************************************************************/
+
+bool SoapyRemoteCluster::hasDCOffsetMode(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->hasDCOffsetMode(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setDCOffsetMode(const int direction, const size_t channel, const bool automatic)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setDCOffsetMode(direction, nodeChannel, automatic);
+}
+
+bool SoapyRemoteCluster::getDCOffsetMode(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getDCOffsetMode(direction, nodeChannel);
+}
+
+bool SoapyRemoteCluster::hasDCOffset(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->hasDCOffset(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setDCOffset(const int direction, const size_t channel, const std::complex<double> &offset)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setDCOffset(direction, nodeChannel, offset);
+}
+
+std::complex<double> SoapyRemoteCluster::getDCOffset(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getDCOffset(direction, nodeChannel);
+}
+
+bool SoapyRemoteCluster::hasIQBalance(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->hasIQBalance(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setIQBalance(const int direction, const size_t channel, const std::complex<double> &balance)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setIQBalance(direction, nodeChannel, balance);
+}
+
+std::complex<double> SoapyRemoteCluster::getIQBalance(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getIQBalance(direction, nodeChannel);
+}
+
+bool SoapyRemoteCluster::hasFrequencyCorrection(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->hasFrequencyCorrection(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setFrequencyCorrection(const int direction, const size_t channel, const double value)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setFrequencyCorrection(direction, nodeChannel, value);
+}
+
+double SoapyRemoteCluster::getFrequencyCorrection(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFrequencyCorrection(direction, nodeChannel);
+}
+
+/*******************************************************************
+ * Gain API
+ ******************************************************************/
+
+std::vector<std::string> SoapyRemoteCluster::listGains(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->listGains(direction, nodeChannel);
+}
+
+bool SoapyRemoteCluster::hasGainMode(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->hasGainMode(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setGainMode(const int direction, const size_t channel, const bool automatic)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setGainMode(direction, nodeChannel, automatic);
+}
+
+bool SoapyRemoteCluster::getGainMode(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getGainMode(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::setGain(const int direction, const size_t channel, const double value)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setGain(direction, nodeChannel, value);
+}
+
+void SoapyRemoteCluster::setGain(const int direction, const size_t channel, const std::string &name, const double value)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setGain(direction, nodeChannel, name, value);
+}
+
+double SoapyRemoteCluster::getGain(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getGain(direction, nodeChannel);
+}
+
+double SoapyRemoteCluster::getGain(const int direction, const size_t channel, const std::string &name) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getGain(direction, nodeChannel, name);
+}
+
+SoapySDR::Range SoapyRemoteCluster::getGainRange(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getGainRange(direction, nodeChannel);
+}
+
+SoapySDR::Range SoapyRemoteCluster::getGainRange(const int direction, const size_t channel, const std::string &name) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getGainRange(direction, nodeChannel, name);
+}
+
+/*******************************************************************
+ * Frequency API
+ ******************************************************************/
+
+void SoapyRemoteCluster::setFrequency(const int direction, const size_t channel, const double frequency, const SoapySDR::Kwargs &args)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setFrequency(direction, nodeChannel, frequency, args);
+}
+
+void SoapyRemoteCluster::setFrequency(const int direction, const size_t channel, const std::string &name, const double frequency, const SoapySDR::Kwargs &args)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setFrequency(direction, nodeChannel, name, frequency, args);
+}
+
+double SoapyRemoteCluster::getFrequency(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFrequency(direction, nodeChannel);
+}
+
+double SoapyRemoteCluster::getFrequency(const int direction, const size_t channel, const std::string &name) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFrequency(direction, nodeChannel, name);
+}
+
+std::vector<std::string> SoapyRemoteCluster::listFrequencies(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->listFrequencies(direction, nodeChannel);
+}
+
+SoapySDR::RangeList SoapyRemoteCluster::getFrequencyRange(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFrequencyRange(direction, nodeChannel);
+}
+
+SoapySDR::RangeList SoapyRemoteCluster::getFrequencyRange(const int direction, const size_t channel, const std::string &name) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFrequencyRange(direction, nodeChannel, name);
+}
+
+SoapySDR::ArgInfoList SoapyRemoteCluster::getFrequencyArgsInfo(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getFrequencyArgsInfo(direction, nodeChannel);
+}
+
+/*******************************************************************
+ * Sample Rate API
+ ******************************************************************/
+
+void SoapyRemoteCluster::setSampleRate(const int direction, const size_t channel, const double rate)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setSampleRate(direction, nodeChannel, rate);
+}
+
+double SoapyRemoteCluster::getSampleRate(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getSampleRate(direction, nodeChannel);
+}
+
+std::vector<double> SoapyRemoteCluster::listSampleRates(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->listSampleRates(direction, nodeChannel);
+}
+
+SoapySDR::RangeList SoapyRemoteCluster::getSampleRateRange(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getSampleRateRange(direction, nodeChannel);
+}
+
+/*******************************************************************
+ * Bandwidth API
+ ******************************************************************/
+
+void SoapyRemoteCluster::setBandwidth(const int direction, const size_t channel, const double bw)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->setBandwidth(direction, nodeChannel, bw);
+}
+
+double SoapyRemoteCluster::getBandwidth(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getBandwidth(direction, nodeChannel);
+}
+
+std::vector<double> SoapyRemoteCluster::listBandwidths(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->listBandwidths(direction, nodeChannel);
+}
+
+SoapySDR::RangeList SoapyRemoteCluster::getBandwidthRange(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getBandwidthRange(direction, nodeChannel);
+}
+
+/*******************************************************************
+ * Clocking API
+ ******************************************************************/
+
+void SoapyRemoteCluster::setMasterClockRate(const double rate)
+{
+    for (const auto node : _nodes) node->setMasterClockRate(rate);
+}
+
+double SoapyRemoteCluster::getMasterClockRate(void) const
+{
+    return _nodes.front()->getMasterClockRate();
+}
+
+SoapySDR::RangeList SoapyRemoteCluster::getMasterClockRates(void) const
+{
+    return _nodes.front()->getMasterClockRates();
+}
+
+std::vector<std::string> SoapyRemoteCluster::listClockSources(void) const
+{
+    return _nodes.front()->listClockSources();
+}
+
+void SoapyRemoteCluster::setClockSource(const std::string &source)
+{
+    for (const auto node : _nodes) node->setClockSource(source);
+}
+
+std::string SoapyRemoteCluster::getClockSource(void) const
+{
+    return _nodes.front()->getClockSource();
+}
+
+/*******************************************************************
+ * Time API
+ ******************************************************************/
+
+std::vector<std::string> SoapyRemoteCluster::listTimeSources(void) const
+{
+    return _nodes.front()->listTimeSources();
+}
+
+void SoapyRemoteCluster::setTimeSource(const std::string &source)
+{
+    for (const auto node : _nodes) node->setTimeSource(source);
+}
+
+std::string SoapyRemoteCluster::getTimeSource(void) const
+{
+    return _nodes.front()->getTimeSource();
+}
+
+bool SoapyRemoteCluster::hasHardwareTime(const std::string &what) const
+{
+    return _nodes.front()->hasHardwareTime(what);
+}
+
+long long SoapyRemoteCluster::getHardwareTime(const std::string &what) const
+{
+    return _nodes.front()->getHardwareTime(what);
+}
+
+void SoapyRemoteCluster::setHardwareTime(const long long timeNs, const std::string &what)
+{
+    //set the nodes together, use a latched time ("pps") for exact alignment
+    parallelFor(_nodes.size(), [&](const size_t i){_nodes[i]->setHardwareTime(timeNs, what);});
+}
+
+void SoapyRemoteCluster::setCommandTime(const long long timeNs, const std::string &what)
+{
+    for (const auto node : _nodes) node->setCommandTime(timeNs, what);
+}
+
+/*******************************************************************
+ * Sensor API
+ ******************************************************************/
+
+std::vector<std::string> SoapyRemoteCluster::listSensors(void) const
+{
+    std::vector<std::string> result;
+    for (size_t i = 0; i < _nodes.size(); i++)
+    {
+        for (const auto &name : _nodes[i]->listSensors()) result.push_back("node" + std::to_string(i) + ":" + name);
+    }
+    return result;
+}
+
+SoapySDR::ArgInfo SoapyRemoteCluster::getSensorInfo(const std::string &name) const
+{
+    std::string nodeName;
+    auto result = this->getNode(name, nodeName)->getSensorInfo(nodeName);
+    result.key = name;
+    return result;
+}
+
+std::string SoapyRemoteCluster::readSensor(const std::string &name) const
+{
+    std::string nodeName;
+    return this->getNode(name, nodeName)->readSensor(nodeName);
+}
+
+std::vector<std::string> SoapyRemoteCluster::listSensors(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->listSensors(direction, nodeChannel);
+}
+
+SoapySDR::ArgInfo SoapyRemoteCluster::getSensorInfo(const int direction, const size_t channel, const std::string &name) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getSensorInfo(direction, nodeChannel, name);
+}
+
+std::string SoapyRemoteCluster::readSensor(const int direction, const size_t channel, const std::string &name) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->readSensor(direction, nodeChannel, name);
+}
+
+/*******************************************************************
+ * Settings API
+ ******************************************************************/
+
+SoapySDR::ArgInfoList SoapyRemoteCluster::getSettingInfo(void) const
+{
+    return _nodes.front()->getSettingInfo();
+}
+
+void SoapyRemoteCluster::writeSetting(const std::string &key, const std::string &value)
+{
+    for (const auto node : _nodes) node->writeSetting(key, value);
+}
+
+std::string SoapyRemoteCluster::readSetting(const std::string &key) const
+{
+    return _nodes.front()->readSetting(key);
+}
+
+SoapySDR::ArgInfoList SoapyRemoteCluster::getSettingInfo(const int direction, const size_t channel) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->getSettingInfo(direction, nodeChannel);
+}
+
+void SoapyRemoteCluster::writeSetting(const int direction, const size_t channel, const std::string &key, const std::string &value)
+{
+    size_t nodeChannel = 0;
+    this->getNode(direction, channel, nodeChannel)->writeSetting(direction, nodeChannel, key, value);
+}
+
+std::string SoapyRemoteCluster::readSetting(const int direction, const size_t channel, const std::string &key) const
+{
+    size_t nodeChannel = 0;
+    return this->getNode(direction, channel, nodeChannel)->readSetting(direction, nodeChannel, key);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "StreamRing.hpp"
+#include <chrono>
+
+SoapyStreamRing::SoapyStreamRing(const size_t numSlots, const size_t numChans, const size_t chanBytes):
+    _slots(numSlots),
+    _writeAcquire(0),
+    _readAcquire(0),
+    _head(0),
+    _tail(0),
+    _closed(false),
+    _waiters(0)
+{
+    for (auto &slot : _slots)
+    {
+        slot.mem.resize(numChans*chanBytes);
+        slot.buffs.resize(numChans);
+        for (size_t i = 0; i < numChans; i++) slot.buffs[i] = slot.mem.data()+(i*chanBytes);
+        slot.numElemsOrErr = 0;
+        slot.flags = 0;
+        slot.timeNs = 0;
+        slot.acquired = false;
+    }
+}
+
+void SoapyStreamRing::close(void)
+{
+    _closed = true;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cond.notify_all();
+}
+
+void SoapyStreamRing::notify(void)
+{
+    //only take the lock when the other side may be sleeping
+    if (_waiters.load() == 0) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cond.notify_all();
+}
+
+/***********************************************************************
+ * producer implementation
+ **********************************************************************/
+bool SoapyStreamRing::waitWrite(const long timeoutUs)
+{
+    auto ready = [this]{return _writeAcquire - _tail.load() < _slots.size();};
+    if (ready() or _closed) return ready();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _waiters++;
+    _cond.wait_for(lock, std::chrono::microseconds(timeoutUs), [&]{return ready() or _closed;});
+    _waiters--;
+    return ready();
+}
+
+size_t SoapyStreamRing::acquireWrite(void)
+{
+    const size_t handle = _writeAcquire++ % _slots.size();
+    _slots[handle].acquired = true;
+    return handle;
+}
+
+void SoapyStreamRing::releaseWrite(const size_t handle)
+{
+    _slots[handle].acquired = false;
+
+    //hand over released slots in order of acquisition
+    size_t head = _head.load();
+    while (head != _writeAcquire and not _slots[head % _slots.size()].acquired) head++;
+    _head.store(head);
+    this->notify();
+}
+
+/***********************************************************************
+ * consumer implementation
+ **********************************************************************/
+bool SoapyStreamRing::waitRead(const long timeoutUs)
+{
+    auto ready = [this]{return _head.load() != _readAcquire;};
+    if (ready() or _closed) return ready();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _waiters++;
+    _cond.wait_for(lock, std::chrono::microseconds(timeoutUs), [&]{return ready() or _closed;});
+    _waiters--;
+    return ready();
+}
+
+size_t SoapyStreamRing::acquireRead(void)
+{
+    const size_t handle = _readAcquire++ % _slots.size();
+    _slots[handle].acquired = true;
+    return handle;
+}
+
+void SoapyStreamRing::releaseRead(const size_t handle)
+{
+    _slots[handle].acquired = false;
+
+    //hand back released slots in order of acquisition
+    size_t tail = _tail.load();
+    while (tail != _readAcquire and not _slots[tail % _slots.size()].acquired) tail++;
+    _tail.store(tail);
+    this->notify();
+}
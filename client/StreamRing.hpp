@@ -0,0 +1,92 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/*!
+ * A single producer, single consumer ring of stream buffers.
+ * Each slot holds one buffer per channel plus the stream metadata.
+ * The producer and consumer each acquire slots in order and may
+ * release them in any order; slots are handed over in order.
+ *
+ * Handing over a slot is lock-free: the mutex and condition variable
+ * are only used by a side that has to sleep while the ring is full/empty.
+ */
+class SoapyStreamRing
+{
+public:
+    struct Slot
+    {
+        std::vector<char> mem;
+        std::vector<void *> buffs;
+        int numElemsOrErr;
+        int flags;
+        long long timeNs;
+        bool acquired;
+    };
+
+    SoapyStreamRing(const size_t numSlots, const size_t numChans, const size_t chanBytes);
+
+    //! The number of slots in the ring
+    size_t getNumSlots(void) const
+    {
+        return _slots.size();
+    }
+
+    //! Wake the waiting side, waits no longer block once closed
+    void close(void);
+
+    //! Access a slot by its handle
+    Slot &getSlot(const size_t handle)
+    {
+        return _slots[handle];
+    }
+
+    /*******************************************************************
+     * producer API
+     ******************************************************************/
+
+    //! Wait for a free slot, return false for timeout
+    bool waitWrite(const long timeoutUs);
+
+    //! Acquire the next free slot (check with waitWrite first)
+    size_t acquireWrite(void);
+
+    //! Release a written slot to the consumer
+    void releaseWrite(const size_t handle);
+
+    /*******************************************************************
+     * consumer API
+     ******************************************************************/
+
+    //! Wait for a written slot, return false for timeout
+    bool waitRead(const long timeoutUs);
+
+    //! Acquire the next written slot (check with waitRead first)
+    size_t acquireRead(void);
+
+    //! Release a consumed slot back to the producer
+    void releaseRead(const size_t handle);
+
+private:
+    std::vector<Slot> _slots;
+
+    //monotonic slot counters, the handle is the counter modulo the size
+    //the producer owns _writeAcquire and _head, the consumer _readAcquire and _tail
+    size_t _writeAcquire;
+    size_t _readAcquire;
+    std::atomic<size_t> _head;
+    std::atomic<size_t> _tail;
+
+    //sleeping support for the blocking side
+    std::atomic<bool> _closed;
+    std::atomic<int> _waiters;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    void notify(void);
+};
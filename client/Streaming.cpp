@@ -3,6 +3,7 @@
 
 #include <SoapySDR/Logger.hpp>
 #include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Errors.hpp>
 #include "SoapyClient.hpp"
 #include "ClientStreamData.hpp"
 #include "SoapyRemoteDefs.hpp"
@@ -10,9 +11,40 @@
 #include "SoapyRPCPacker.hpp"
 #include "SoapyRPCUnpacker.hpp"
 #include "SoapyStreamEndpoint.hpp"
-#include <algorithm> //std::min, std::find
+#include "StreamRing.hpp"
+#include "SoapySocketPool.hpp"
+#include "ClientStatusChannel.hpp"
+#include <algorithm> //std::min, std::max, std::find, std::copy
 #include <memory> //unique_ptr
 
+/*******************************************************************
+ * Supported conversions between local and remote formats
+ ******************************************************************/
+static bool findConvertType(const std::string &localFormat, const std::string &remoteFormat, ConvertTypes &convertType)
+{
+    if (localFormat == remoteFormat) convertType = CONVERT_MEMCPY;
+    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CS16) convertType = CONVERT_CF32_CS16;
+    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CS12) convertType = CONVERT_CF32_CS12;
+    else if (localFormat == SOAPY_SDR_CS16 and remoteFormat == SOAPY_SDR_CS12) convertType = CONVERT_CS16_CS12;
+    else if (localFormat == SOAPY_SDR_CS16 and remoteFormat == SOAPY_SDR_CS8) convertType = CONVERT_CS16_CS8;
+    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CS8) convertType = CONVERT_CF32_CS8;
+    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CU8) convertType = CONVERT_CF32_CU8;
+    else return false;
+    return true;
+}
+
+static std::vector<std::string> convertibleFormats(const std::string &localFormat)
+{
+    std::vector<std::string> formats;
+    ConvertTypes convertType = CONVERT_MEMCPY;
+    for (const auto &remoteFormat : {localFormat, std::string(SOAPY_SDR_CS16),
+        std::string(SOAPY_SDR_CS12), std::string(SOAPY_SDR_CS8), std::string(SOAPY_SDR_CU8)})
+    {
+        if (findConvertType(localFormat, remoteFormat, convertType)) formats.push_back(remoteFormat);
+    }
+    return formats;
+}
+
 std::vector<std::string> SoapyRemoteDevice::__getRemoteOnlyStreamFormats(const int direction, const size_t channel) const
 {
     std::lock_guard<std::mutex> lock(_mutex);
@@ -98,7 +130,7 @@ SoapySDR::ArgInfoList SoapyRemoteDevice::getStreamArgsInfo(const int direction,
     mtuArg.value = std::to_string(SOAPY_REMOTE_DEFAULT_ENDPOINT_MTU);
     mtuArg.name = "Remote MTU";
     mtuArg.units = "bytes";
-    mtuArg.description = "The maximum datagram transfer size in bytes.";
+    mtuArg.description = "The maximum datagram transfer size in bytes (the TCP default is 256 KiB).";
     mtuArg.type = SoapySDR::ArgInfo::INT;
     result.push_back(mtuArg);
 
@@ -111,6 +143,15 @@ SoapySDR::ArgInfoList SoapyRemoteDevice::getStreamArgsInfo(const int direction,
     windowArg.type = SoapySDR::ArgInfo::INT;
     result.push_back(windowArg);
 
+    SoapySDR::ArgInfo stripesArg;
+    stripesArg.key = "remote:stripes";
+    stripesArg.value = "1";
+    stripesArg.name = "Remote Stripes";
+    stripesArg.description = "The number of TCP connections to stripe the stream across (prot=tcp).";
+    stripesArg.type = SoapySDR::ArgInfo::INT;
+    stripesArg.range = SoapySDR::Range(1, SOAPY_REMOTE_MAX_STRIPES);
+    result.push_back(stripesArg);
+
     SoapySDR::ArgInfo priorityArg;
     priorityArg.key = "remote:priority";
     priorityArg.value = std::to_string(SOAPY_REMOTE_DEFAULT_THREAD_PRIORITY);
@@ -129,6 +170,88 @@ SoapySDR::ArgInfoList SoapyRemoteDevice::getStreamArgsInfo(const int direction,
     protArg.options = {"udp", "tcp", "none"};
     result.push_back(protArg);
 
+    SoapySDR::ArgInfo activateArg;
+    activateArg.key = "remote:activate";
+    activateArg.value = "false";
+    activateArg.name = "Remote Activate";
+    activateArg.description = "Activate the stream in the same exchange that sets it up.";
+    activateArg.type = SoapySDR::ArgInfo::BOOL;
+    result.push_back(activateArg);
+
+    if (direction == SOAPY_SDR_RX)
+    {
+        SoapySDR::ArgInfo historyArg;
+        historyArg.key = "remote:history";
+        historyArg.value = "0";
+        historyArg.name = "Remote History";
+        historyArg.units = "seconds";
+        historyArg.description = "Keep the last N seconds of the stream in server memory for replay streams.";
+        historyArg.type = SoapySDR::ArgInfo::FLOAT;
+        result.push_back(historyArg);
+
+        SoapySDR::ArgInfo replayArg;
+        replayArg.key = "remote:replay";
+        replayArg.value = "false";
+        replayArg.name = "Remote Replay";
+        replayArg.description = "Replay windows from the history of a stream on the same channels (activateStream selects the window by time).";
+        replayArg.type = SoapySDR::ArgInfo::BOOL;
+        result.push_back(replayArg);
+
+        SoapySDR::ArgInfo recordOnlyArg;
+        recordOnlyArg.key = "remote:record_only";
+        recordOnlyArg.value = "false";
+        recordOnlyArg.name = "Remote Record Only";
+        recordOnlyArg.description = "Read the stream on the server for the remote:record channel setting without sending samples to the client.";
+        recordOnlyArg.type = SoapySDR::ArgInfo::BOOL;
+        result.push_back(recordOnlyArg);
+
+        SoapySDR::ArgInfo prefetchArg;
+        prefetchArg.key = "remote:prefetch";
+        prefetchArg.value = "0";
+        prefetchArg.name = "Remote Prefetch";
+        prefetchArg.units = "bytes";
+        prefetchArg.description = "Drain the stream socket into a client side ring of this size on a dedicated thread (0 disables).";
+        prefetchArg.type = SoapySDR::ArgInfo::INT;
+        result.push_back(prefetchArg);
+    }
+
+    if (direction == SOAPY_SDR_TX)
+    {
+        SoapySDR::ArgInfo prefillArg;
+        prefillArg.key = "remote:prefill";
+        prefillArg.value = "0";
+        prefillArg.name = "Remote Prefill";
+        prefillArg.units = "elements";
+        prefillArg.description = "Buffer this many elements on the server before writing each burst to the device (0 disables).";
+        prefillArg.type = SoapySDR::ArgInfo::INT;
+        result.push_back(prefillArg);
+
+        SoapySDR::ArgInfo latencyArg;
+        latencyArg.key = "remote:latency";
+        latencyArg.value = "0";
+        latencyArg.name = "Remote Latency";
+        latencyArg.units = "us";
+        latencyArg.description = "Target latency of the server's transmit jitter buffer (0 disables).";
+        latencyArg.type = SoapySDR::ArgInfo::FLOAT;
+        result.push_back(latencyArg);
+
+        SoapySDR::ArgInfo waveformArg;
+        waveformArg.key = "remote:waveform";
+        waveformArg.name = "Remote Waveform";
+        waveformArg.description = "Upload the written samples to the server's waveform cache under this name (remote:play channel setting).";
+        waveformArg.type = SoapySDR::ArgInfo::STRING;
+        result.push_back(waveformArg);
+
+        SoapySDR::ArgInfo queueArg;
+        queueArg.key = "remote:queue";
+        queueArg.value = "0";
+        queueArg.name = "Remote Queue";
+        queueArg.units = "bytes";
+        queueArg.description = "Queue written samples in a client side ring of this size and send them on a dedicated thread (0 disables).";
+        queueArg.type = SoapySDR::ArgInfo::INT;
+        result.push_back(queueArg);
+    }
+
     return result;
 }
 
@@ -145,8 +268,11 @@ SoapySDR::Stream *SoapyRemoteDevice::setupStream(
     const auto protIt = args.find(SOAPY_REMOTE_KWARG_PROT);
     if (protIt != args.end()) prot = protIt->second;
 
-    //setup the stream in bypass mode for protocol none
-    if (prot == "none")
+    //setup the stream in bypass mode for protocol none,
+    //record-only streams are bypass streams that the server records
+    const auto recordOnlyIt = args.find(SOAPY_REMOTE_KWARG_RECORD_ONLY);
+    const bool recordOnly = (direction == SOAPY_SDR_RX and recordOnlyIt != args.end() and recordOnlyIt->second == "true");
+    if (prot == "none" or recordOnly)
     {
         auto data = std::unique_ptr<ClientStreamData>(new ClientStreamData());
         std::lock_guard<std::mutex> lock(_mutex);
@@ -168,28 +294,37 @@ SoapySDR::Stream *SoapyRemoteDevice::setupStream(
     auto channels = channels_;
     if (channels.empty()) channels.push_back(0);
 
-    //use the remote device's native stream format and scale factor when the conversion is supported
-    double nativeScaleFactor = 0.0;
-    auto nativeFormat = this->getNativeStreamFormat(direction, channels.front(), nativeScaleFactor);
-    const bool useNative = (localFormat == nativeFormat) or
-        (localFormat == SOAPY_SDR_CF32 and nativeFormat == SOAPY_SDR_CS16) or
-        (localFormat == SOAPY_SDR_CF32 and nativeFormat == SOAPY_SDR_CS12) or
-        (localFormat == SOAPY_SDR_CS16 and nativeFormat == SOAPY_SDR_CS12) or
-        (localFormat == SOAPY_SDR_CS16 and nativeFormat == SOAPY_SDR_CS8) or
-        (localFormat == SOAPY_SDR_CF32 and nativeFormat == SOAPY_SDR_CS8) or
-        (localFormat == SOAPY_SDR_CF32 and nativeFormat == SOAPY_SDR_CU8);
-
-    //use the native format when the conversion is supported,
-    //otherwise use the client's local format for the default
-    auto remoteFormat = useNative?nativeFormat:localFormat;
+    //newer servers negotiate the format and scale in the setup call,
+    //waveform upload streams have no setup call and ask for the format
+    const auto waveformIt = args.find(SOAPY_REMOTE_KWARG_WAVEFORM);
+    const bool waveformMode = (direction == SOAPY_SDR_TX and waveformIt != args.end());
+    const bool negotiate = (_remoteRPCVersion >= SoapyRPCVersionNegotiate) and not waveformMode;
+
+    //a remote format specified in the args is used as-is
+    std::string remoteFormat;
     const auto remoteFormatIt = args.find(SOAPY_REMOTE_KWARG_FORMAT);
     if (remoteFormatIt != args.end()) remoteFormat = remoteFormatIt->second;
 
-    //use the native scale factor when the remote format is native,
-    //otherwise the default scale factor is the max signed integer
-    double scaleFactor = (remoteFormat == nativeFormat)?nativeScaleFactor:double(1 << ((SoapySDR::formatToSize(remoteFormat)*4)-1));
+    double scaleFactor = 0.0;
     const auto scaleFactorIt = args.find(SOAPY_REMOTE_KWARG_SCALE);
-    if (scaleFactorIt != args.end()) scaleFactor = std::stod(scaleFactorIt->second);
+    ConvertTypes convertType = CONVERT_MEMCPY;
+
+    //use the remote device's native stream format and scale factor when the conversion is supported
+    if (not negotiate)
+    {
+        double nativeScaleFactor = 0.0;
+        auto nativeFormat = this->getNativeStreamFormat(direction, channels.front(), nativeScaleFactor);
+        const bool useNative = findConvertType(localFormat, nativeFormat, convertType);
+
+        //use the native format when the conversion is supported,
+        //otherwise use the client's local format for the default
+        if (remoteFormat.empty()) remoteFormat = useNative?nativeFormat:localFormat;
+
+        //use the native scale factor when the remote format is native,
+        //otherwise the default scale factor is the max signed integer
+        scaleFactor = (remoteFormat == nativeFormat)?nativeScaleFactor:double(1 << ((SoapySDR::formatToSize(remoteFormat)*4)-1));
+        if (scaleFactorIt != args.end()) scaleFactor = std::stod(scaleFactorIt->second);
+    }
 
     //determine reliable stream mode with tcp or datagram mode
     const bool datagramMode = (prot == "udp");
@@ -200,29 +335,36 @@ SoapySDR::Stream *SoapyRemoteDevice::setupStream(
         "expected 'udp' or 'tcp', but got '"+prot+"'");
     args[SOAPY_REMOTE_KWARG_PROT] = prot;
 
-    size_t mtu = datagramMode?SOAPY_REMOTE_DEFAULT_ENDPOINT_MTU:SOAPY_REMOTE_SOCKET_BUFFMAX;
-    const auto mtuIt = args.find(SOAPY_REMOTE_KWARG_MTU);
-    if (mtuIt != args.end()) mtu = size_t(std::stod(mtuIt->second));
-    args[SOAPY_REMOTE_KWARG_MTU] = std::to_string(mtu);
-
     size_t window = SOAPY_REMOTE_DEFAULT_ENDPOINT_WINDOW;
     const auto windowIt = args.find(SOAPY_REMOTE_KWARG_WINDOW);
     if (windowIt != args.end()) window = size_t(std::stod(windowIt->second));
     args[SOAPY_REMOTE_KWARG_WINDOW] = std::to_string(window);
 
-    SoapySDR::logf(SOAPY_SDR_INFO, "SoapyRemote::setup%sStream(remoteFormat=%s, localFormat=%s, scaleFactor=%g, mtu=%d, window=%d)",
+    //tcp frames default to large frames that still fit the window several times
+    size_t mtu = SOAPY_REMOTE_DEFAULT_ENDPOINT_MTU;
+    if (not datagramMode) mtu = std::max<size_t>(SOAPY_REMOTE_SOCKET_BUFFMAX,
+        std::min<size_t>(SOAPY_REMOTE_DEFAULT_TCP_ENDPOINT_MTU, window/SOAPY_REMOTE_ENDPOINT_NUM_BUFFS));
+    const auto mtuIt = args.find(SOAPY_REMOTE_KWARG_MTU);
+    if (mtuIt != args.end()) mtu = size_t(std::stod(mtuIt->second));
+    args[SOAPY_REMOTE_KWARG_MTU] = std::to_string(mtu);
+
+    //older servers do not accept the extra stripe connections
+    size_t numStripes = 1;
+    const auto stripesIt = args.find(SOAPY_REMOTE_KWARG_STRIPES);
+    if (not datagramMode and stripesIt != args.end()) numStripes = std::max<size_t>(1, std::min<size_t>(SOAPY_REMOTE_MAX_STRIPES, std::stoul(stripesIt->second)));
+    if (numStripes > 1 and _remoteRPCVersion < SoapyRPCVersionStripes)
+    {
+        SoapySDR::log(SOAPY_SDR_WARNING, "SoapyRemote::setupStream() -- server does not support stripes");
+        numStripes = 1;
+    }
+    args.erase(SOAPY_REMOTE_KWARG_STRIPES);
+    if (numStripes > 1) args[SOAPY_REMOTE_KWARG_STRIPES] = std::to_string(numStripes);
+
+    if (not negotiate) SoapySDR::logf(SOAPY_SDR_INFO, "SoapyRemote::setup%sStream(remoteFormat=%s, localFormat=%s, scaleFactor=%g, mtu=%d, window=%d)",
         (direction == SOAPY_SDR_RX)?"Rx":"Tx", remoteFormat.c_str(), localFormat.c_str(), scaleFactor, int(mtu), int(window));
 
-    //check supported formats
-    ConvertTypes convertType = CONVERT_MEMCPY;
-    if (localFormat == remoteFormat) convertType = CONVERT_MEMCPY;
-    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CS16) convertType = CONVERT_CF32_CS16;
-    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CS12) convertType = CONVERT_CF32_CS12;
-    else if (localFormat == SOAPY_SDR_CS16 and remoteFormat == SOAPY_SDR_CS12) convertType = CONVERT_CS16_CS12;
-    else if (localFormat == SOAPY_SDR_CS16 and remoteFormat == SOAPY_SDR_CS8) convertType = CONVERT_CS16_CS8;
-    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CS8) convertType = CONVERT_CF32_CS8;
-    else if (localFormat == SOAPY_SDR_CF32 and remoteFormat == SOAPY_SDR_CU8) convertType = CONVERT_CF32_CU8;
-    else throw std::runtime_error(
+    //check supported formats (before the server negotiates a format)
+    if (not remoteFormat.empty() and not findConvertType(localFormat, remoteFormat, convertType)) throw std::runtime_error(
         "SoapyRemote::setupStream() conversion not supported;"
         "localFormat="+localFormat+", remoteFormat="+remoteFormat);
 
@@ -235,42 +377,103 @@ SoapySDR::Stream *SoapyRemoteDevice::setupStream(
     data->convertType = convertType;
     data->scaleFactor = scaleFactor;
 
+    const auto replayIt = args.find(SOAPY_REMOTE_KWARG_REPLAY);
+    data->replay = (replayIt != args.end() and replayIt->second == "true");
+
+    //waveform upload streams buffer locally and upload with a single call
+    if (waveformMode)
+    {
+        data->waveform = waveformIt->second;
+        data->waveformBuffs.resize(channels.size());
+        return (SoapySDR::Stream *)data.release();
+    }
+
     //extract socket node information
     const auto localNode = SoapyURL(_sock.getsockname()).getNode();
     const auto remoteNode = SoapyURL(_sock.getpeername()).getNode();
 
+    //newer servers send the status of all datagram streams on one channel,
+    //fall back to a status socket per stream when the channel setup fails
+    if (datagramMode and _remoteRPCVersion >= SoapyRPCVersionStatusChannel)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_statusChannel == nullptr) try
+        {
+            std::unique_ptr<ClientStatusChannel> statusChannel(new ClientStatusChannel(SoapyURL("udp", localNode, "0").toString()));
+            SoapyRPCPacker packer(_sock);
+            packer & SOAPY_REMOTE_SETUP_STATUS_CHANNEL;
+            packer & statusChannel->getBindPort();
+            packer();
+            SoapyRPCUnpacker unpacker(_sock);
+            _statusChannel = statusChannel.release();
+        }
+        catch (const std::exception &ex)
+        {
+            SoapySDR::logf(SOAPY_SDR_WARNING, "SoapyRemote::setupStream() status channel FAIL: %s", ex.what());
+        }
+        data->statusChannel = _statusChannel;
+    }
+
+    //datagram sockets are reused from the pool, tcp connects new sockets;
+    //streams on the status channel leave their status socket unused
+    if (datagramMode and data->statusChannel != nullptr)
+    {
+        _socketPool->acquire(data->streamSock);
+        data->statusSock = new SoapyRPCSocket();
+    }
+    else if (datagramMode) _socketPool->acquire(data->streamSock, data->statusSock);
+    else
+    {
+        data->streamSock = new SoapyRPCSocket();
+        data->statusSock = new SoapyRPCSocket();
+    }
+
     //bind the receiver side of the sockets in datagram mode
     std::string clientBindPort, statusBindPort;
     if (datagramMode)
     {
-        //bind the stream socket to an automatic port
+        //bind the stream socket to an automatic port (unless reused)
         const auto bindURL = SoapyURL("udp", localNode, "0").toString();
-        int ret = data->streamSock.bind(bindURL);
+        int ret = data->streamSock->null()?data->streamSock->bind(bindURL):0;
         if (ret != 0)
         {
-            const std::string errorMsg = data->streamSock.lastErrorMsg();
+            const std::string errorMsg = data->streamSock->lastErrorMsg();
             throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- bind FAIL: " + errorMsg);
         }
-        SoapySDR::logf(SOAPY_SDR_INFO, "Client side stream bound to %s", data->streamSock.getsockname().c_str());
-        clientBindPort = SoapyURL(data->streamSock.getsockname()).getService();
+        SoapySDR::logf(SOAPY_SDR_INFO, "Client side stream bound to %s", data->streamSock->getsockname().c_str());
+        clientBindPort = SoapyURL(data->streamSock->getsockname()).getService();
 
-        //bind the status socket to an automatic port
-        ret = data->statusSock.bind(bindURL);
+        //bind the status socket to an automatic port (unless reused),
+        //an empty status port tells the server to use the status channel
+        ret = (data->statusChannel == nullptr and data->statusSock->null())?data->statusSock->bind(bindURL):0;
         if (ret != 0)
         {
-            const std::string errorMsg = data->statusSock.lastErrorMsg();
+            const std::string errorMsg = data->statusSock->lastErrorMsg();
             throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- bind FAIL: " + errorMsg);
         }
-        SoapySDR::logf(SOAPY_SDR_INFO, "Client side status bound to %s", data->statusSock.getsockname().c_str());
-        statusBindPort = SoapyURL(data->statusSock.getsockname()).getService();
+        if (data->statusChannel == nullptr)
+        {
+            SoapySDR::logf(SOAPY_SDR_INFO, "Client side status bound to %s", data->statusSock->getsockname().c_str());
+            statusBindPort = SoapyURL(data->statusSock->getsockname()).getService();
+        }
     }
 
     //setup the remote end of the stream
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
-    packer & SOAPY_REMOTE_SETUP_STREAM;
-    packer & char(direction);
-    packer & remoteFormat;
+    if (negotiate)
+    {
+        packer & SOAPY_REMOTE_SETUP_STREAM_NEGOTIATE;
+        packer & char(direction);
+        packer & localFormat;
+        packer & convertibleFormats(localFormat);
+    }
+    else
+    {
+        packer & SOAPY_REMOTE_SETUP_STREAM;
+        packer & char(direction);
+        packer & remoteFormat;
+    }
     packer & channels;
     packer & args;
     packer & clientBindPort;
@@ -284,18 +487,28 @@ SoapySDR::Stream *SoapyRemoteDevice::setupStream(
         SoapyRPCUnpacker unpackerTcp(_sock);
         unpackerTcp & serverBindPort;
         const auto connectURL = SoapyURL(prot, remoteNode, serverBindPort).toString();
-        int ret = data->streamSock.connect(connectURL);
+        int ret = data->streamSock->connect(connectURL);
         if (ret != 0)
         {
-            const std::string errorMsg = data->streamSock.lastErrorMsg();
+            const std::string errorMsg = data->streamSock->lastErrorMsg();
             throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
         }
-        ret = data->statusSock.connect(connectURL);
+        ret = data->statusSock->connect(connectURL);
         if (ret != 0)
         {
-            const std::string errorMsg = data->statusSock.lastErrorMsg();
+            const std::string errorMsg = data->statusSock->lastErrorMsg();
             throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
         }
+        for (size_t i = 1; i < numStripes; i++)
+        {
+            data->stripeSocks.push_back(new SoapyRPCSocket());
+            ret = data->stripeSocks.back()->connect(connectURL);
+            if (ret != 0)
+            {
+                const std::string errorMsg = data->stripeSocks.back()->lastErrorMsg();
+                throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
+            }
+        }
     }
 
     //and wait for the response with binding port and stream id
@@ -303,24 +516,82 @@ SoapySDR::Stream *SoapyRemoteDevice::setupStream(
     unpacker & data->streamId;
     unpacker & serverBindPort;
 
+    //the negotiated format, scale, and activation result
+    int activateResult = 0;
+    if (negotiate)
+    {
+        unpacker & remoteFormat;
+        unpacker & scaleFactor;
+        unpacker & activateResult;
+        findConvertType(localFormat, remoteFormat, convertType);
+        data->remoteFormat = remoteFormat;
+        data->convertType = convertType;
+        data->scaleFactor = scaleFactor;
+
+        SoapySDR::logf(SOAPY_SDR_INFO, "SoapyRemote::setup%sStream(remoteFormat=%s, localFormat=%s, scaleFactor=%g, mtu=%d, window=%d)",
+            (direction == SOAPY_SDR_RX)?"Rx":"Tx", remoteFormat.c_str(), localFormat.c_str(), scaleFactor, int(mtu), int(window));
+    }
+
     //connect the sending end of the stream socket
     if (datagramMode)
     {
         //connect the stream socket to the specified port
         const auto connectURL = SoapyURL(prot, remoteNode, serverBindPort).toString();
-        int ret = data->streamSock.connect(connectURL);
+        int ret = data->streamSock->connect(connectURL);
         if (ret != 0)
         {
-            const std::string errorMsg = data->streamSock.lastErrorMsg();
+            const std::string errorMsg = data->streamSock->lastErrorMsg();
             throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
         }
-        SoapySDR::logf(SOAPY_SDR_INFO, "Client side stream connected to %s", data->streamSock.getpeername().c_str());
+        SoapySDR::logf(SOAPY_SDR_INFO, "Client side stream connected to %s", data->streamSock->getpeername().c_str());
     }
 
+    //the datagram sockets go back to the pool when the stream closes
+    if (datagramMode) data->socketPool = _socketPool;
+
     //create endpoint
-    data->endpoint = new SoapyStreamEndpoint(data->streamSock, data->statusSock,
+    data->endpoint = new SoapyStreamEndpoint(*data->streamSock, *data->statusSock,
         datagramMode, direction == SOAPY_SDR_RX, channels.size(),
-        SoapySDR::formatToSize(remoteFormat), mtu, window);
+        SoapySDR::formatToSize(remoteFormat), mtu, window, data->socketPool);
+    if (not data->stripeSocks.empty()) data->endpoint->setStripes(data->stripeSocks);
+
+    //activate in the setup exchange, or with a separate call for older servers
+    const auto activateIt = args.find(SOAPY_REMOTE_KWARG_ACTIVATE);
+    if (activateIt != args.end() and activateIt->second == "true")
+    {
+        if (not negotiate)
+        {
+            SoapyRPCPacker packerActivate(_sock);
+            if (data->replay) packerActivate & SOAPY_REMOTE_REPLAY_STREAM_HISTORY;
+            else packerActivate & SOAPY_REMOTE_ACTIVATE_STREAM;
+            packerActivate & data->streamId;
+            packerActivate & int(0);
+            packerActivate & (long long)(0);
+            packerActivate & int(0);
+            packerActivate();
+            SoapyRPCUnpacker unpackerActivate(_sock);
+            unpackerActivate & activateResult;
+        }
+        if (activateResult != 0) SoapySDR::logf(SOAPY_SDR_WARNING,
+            "SoapyRemote::setupStream() activate failed: %s", SoapySDR::errToStr(activateResult));
+        data->setupActivated = (activateResult == 0);
+    }
+
+    //drain the receive socket into a user-space ring on a dedicated thread
+    const auto prefetchIt = args.find(SOAPY_REMOTE_KWARG_PREFETCH);
+    if (direction == SOAPY_SDR_RX and prefetchIt != args.end())
+    {
+        const size_t prefetch = size_t(std::stod(prefetchIt->second));
+        if (prefetch != 0) data->startPrefetch(prefetch);
+    }
+
+    //drain a user-space queue into the transmit socket on a dedicated thread
+    const auto queueIt = args.find(SOAPY_REMOTE_KWARG_QUEUE);
+    if (direction == SOAPY_SDR_TX and queueIt != args.end())
+    {
+        const size_t queue = size_t(std::stod(queueIt->second));
+        if (queue != 0) data->startSendQueue(queue);
+    }
 
     return (SoapySDR::Stream *)data.release();
 }
@@ -329,6 +600,17 @@ void SoapyRemoteDevice::closeStream(SoapySDR::Stream *stream)
 {
     auto data = (ClientStreamData *)stream;
 
+    //upload any remaining waveform samples, there is no remote stream
+    if (not data->waveform.empty())
+    {
+        std::unique_ptr<ClientStreamData> cleanup(data);
+        if (not data->waveformBuffs.front().empty()) this->uploadWaveform(data);
+        return;
+    }
+
+    //stop using the endpoint before the remote end goes away
+    data->stopIoThread();
+
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
     packer & SOAPY_REMOTE_CLOSE_STREAM;
@@ -338,6 +620,7 @@ void SoapyRemoteDevice::closeStream(SoapySDR::Stream *stream)
     SoapyRPCUnpacker unpacker(_sock);
 
     //cleanup local stream data
+    if (data->statusChannel != nullptr) data->statusChannel->remove(data->streamId);
     delete data->endpoint;
     delete data;
 }
@@ -345,6 +628,7 @@ void SoapyRemoteDevice::closeStream(SoapySDR::Stream *stream)
 size_t SoapyRemoteDevice::getStreamMTU(SoapySDR::Stream *stream) const
 {
     auto data = (ClientStreamData *)stream;
+    if (data->endpoint == nullptr) return SoapySDR::Device::getStreamMTU(stream);
     return data->endpoint->getBuffSize();
     return SoapySDR::Device::getStreamMTU(stream);
 }
@@ -356,10 +640,19 @@ int SoapyRemoteDevice::activateStream(
     const size_t numElems)
 {
     auto data = (ClientStreamData *)stream;
+    if (not data->waveform.empty()) return 0;
+
+    //the stream was already activated by its setup call
+    if (data->setupActivated)
+    {
+        data->setupActivated = false;
+        if (flags == 0 and timeNs == 0 and numElems == 0) return 0;
+    }
 
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
-    packer & SOAPY_REMOTE_ACTIVATE_STREAM;
+    if (data->replay) packer & SOAPY_REMOTE_REPLAY_STREAM_HISTORY;
+    else packer & SOAPY_REMOTE_ACTIVATE_STREAM;
     packer & data->streamId;
     packer & flags;
     packer & timeNs;
@@ -378,6 +671,8 @@ int SoapyRemoteDevice::deactivateStream(
     const long long timeNs)
 {
     auto data = (ClientStreamData *)stream;
+    if (not data->waveform.empty()) return 0;
+    data->setupActivated = false;
 
     std::lock_guard<std::mutex> lock(_mutex);
     SoapyRPCPacker packer(_sock);
@@ -446,6 +741,22 @@ int SoapyRemoteDevice::writeStream(
 {
     auto data = (ClientStreamData *)stream;
 
+    //waveform upload streams convert into the local buffers
+    if (not data->waveform.empty())
+    {
+        const size_t elemSize = SoapySDR::formatToSize(data->remoteFormat);
+        for (size_t i = 0; i < data->sendBuffs.size(); i++)
+        {
+            auto &buff = data->waveformBuffs[i];
+            const size_t offset = buff.size();
+            buff.resize(offset + numElems*elemSize);
+            data->sendBuffs[i] = &buff[offset];
+        }
+        data->convertSendBuffs(buffs, numElems);
+        if ((flags & SOAPY_SDR_END_BURST) != 0) this->uploadWaveform(data);
+        return numElems;
+    }
+
     //acquire from direct buffer access
     size_t handle = 0;
     int ret = this->acquireWriteBuffer(stream, handle, data->sendBuffs.data(), timeoutUs);
@@ -463,6 +774,32 @@ int SoapyRemoteDevice::writeStream(
     return numSamples;
 }
 
+void SoapyRemoteDevice::uploadWaveform(ClientStreamData *data)
+{
+    //concatenate the channels into a single upload
+    const size_t elemSize = SoapySDR::formatToSize(data->remoteFormat);
+    const size_t numElems = data->waveformBuffs.front().size()/elemSize;
+    std::string samples;
+    samples.reserve(numElems*elemSize*data->waveformBuffs.size());
+    for (auto &buff : data->waveformBuffs)
+    {
+        samples += buff;
+        buff.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    SoapyRPCPacker packer(_sock);
+    packer & SOAPY_REMOTE_UPLOAD_WAVEFORM;
+    packer & data->waveform;
+    packer & data->remoteFormat;
+    packer & int(data->waveformBuffs.size());
+    packer & int(numElems);
+    packer & samples;
+    packer();
+
+    SoapyRPCUnpacker unpacker(_sock);
+}
+
 int SoapyRemoteDevice::readStreamStatus(
     SoapySDR::Stream *stream,
     size_t &chanMask,
@@ -471,7 +808,19 @@ int SoapyRemoteDevice::readStreamStatus(
     const long timeoutUs)
 {
     auto data = (ClientStreamData *)stream;
+
+    //the stream thread stopped on an endpoint error, report it once
+    if (data->ioError != 0 and not data->ioErrorReported.exchange(true))
+    {
+        chanMask = (size_t(1) << data->endpoint->getNumChans()) - 1;
+        flags = 0;
+        timeNs = 0;
+        return data->ioError;
+    }
+
+    if (data->statusChannel != nullptr) return data->statusChannel->read(data->streamId, chanMask, flags, timeNs, timeoutUs);
     auto ep = data->endpoint;
+    if (ep == nullptr) return SOAPY_SDR_NOT_SUPPORTED;
     if (not ep->waitStatus(timeoutUs)) return SOAPY_SDR_TIMEOUT;
     return ep->readStatus(chanMask, flags, timeNs);
 }
@@ -483,12 +832,19 @@ int SoapyRemoteDevice::readStreamStatus(
 size_t SoapyRemoteDevice::getNumDirectAccessBuffers(SoapySDR::Stream *stream)
 {
     auto data = (ClientStreamData *)stream;
+    if (data->ring != nullptr) return data->ring->getNumSlots();
     return data->endpoint->getNumBuffs();
 }
 
 int SoapyRemoteDevice::getDirectAccessBufferAddrs(SoapySDR::Stream *stream, const size_t handle, void **buffs)
 {
     auto data = (ClientStreamData *)stream;
+    if (data->ring != nullptr)
+    {
+        const auto &slotBuffs = data->ring->getSlot(handle).buffs;
+        std::copy(slotBuffs.begin(), slotBuffs.end(), buffs);
+        return 0;
+    }
     data->endpoint->getAddrs(handle, buffs);
     return 0;
 }
@@ -502,7 +858,25 @@ int SoapyRemoteDevice::acquireReadBuffer(
     const long timeoutUs)
 {
     auto data = (ClientStreamData *)stream;
+
+    //consume from the prefetch ring, errors do not hold a slot
+    auto ring = data->ring;
+    if (ring != nullptr)
+    {
+        if (not ring->waitRead(timeoutUs)) return (data->ioError != 0)?int(data->ioError):SOAPY_SDR_TIMEOUT;
+        handle = ring->acquireRead();
+        const auto &slot = ring->getSlot(handle);
+        flags = slot.flags;
+        timeNs = slot.timeNs;
+        const int ret = slot.numElemsOrErr;
+        if (ret < 0) ring->releaseRead(handle);
+        else std::copy(slot.buffs.begin(), slot.buffs.end(), buffs);
+        return ret;
+    }
+
+    //bypass and record-only streams have no samples on the client
     auto ep = data->endpoint;
+    if (ep == nullptr) return SOAPY_SDR_NOT_SUPPORTED;
     if (not ep->waitRecv(timeoutUs)) return SOAPY_SDR_TIMEOUT;
     return ep->acquireRecv(handle, buffs, flags, timeNs);
 }
@@ -512,6 +886,7 @@ void SoapyRemoteDevice::releaseReadBuffer(
     const size_t handle)
 {
     auto data = (ClientStreamData *)stream;
+    if (data->ring != nullptr) return data->ring->releaseRead(handle);
     auto ep = data->endpoint;
     return ep->releaseRecv(handle);
 }
@@ -523,6 +898,19 @@ int SoapyRemoteDevice::acquireWriteBuffer(
     const long timeoutUs)
 {
     auto data = (ClientStreamData *)stream;
+
+    //fill the send queue, the send thread handles flow control
+    auto ring = data->ring;
+    if (ring != nullptr)
+    {
+        if (data->ioError != 0) return data->ioError;
+        if (not ring->waitWrite(timeoutUs)) return SOAPY_SDR_TIMEOUT;
+        handle = ring->acquireWrite();
+        const auto &slotBuffs = ring->getSlot(handle).buffs;
+        std::copy(slotBuffs.begin(), slotBuffs.end(), buffs);
+        return int(data->endpoint->getBuffSize());
+    }
+
     auto ep = data->endpoint;
     if (not ep->waitSend(timeoutUs)) return SOAPY_SDR_TIMEOUT;
     return ep->acquireSend(handle, buffs);
@@ -536,6 +924,14 @@ void SoapyRemoteDevice::releaseWriteBuffer(
     const long long timeNs)
 {
     auto data = (ClientStreamData *)stream;
+    if (data->ring != nullptr)
+    {
+        auto &slot = data->ring->getSlot(handle);
+        slot.numElemsOrErr = int(numElems);
+        slot.flags = flags;
+        slot.timeNs = timeNs;
+        return data->ring->releaseWrite(handle);
+    }
     auto ep = data->endpoint;
     return ep->releaseSend(handle, numElems, flags, timeNs);
 }
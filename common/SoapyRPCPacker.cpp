@@ -66,6 +66,7 @@ void SoapyRPCPacker::ensureSpace(const size_t length)
     if (_size+length <= _capacity) return;
     const size_t newSize = std::max(_capacity*2, _size+length);
     _message = (char *)realloc(_message, newSize);
+    _capacity = newSize;
 }
 
 void SoapyRPCPacker::pack(const void *buff, const size_t length)
@@ -132,8 +133,8 @@ void SoapyRPCPacker::operator&(const SoapySDR::Range &value)
     *this & value.minimum();
     *this & value.maximum();
 
-    //a step size is sent when the remote version matches our current
-    if (_remoteRPCVersion >= SoapyRPCVersion)
+    //a step size is sent when the remote version supports it
+    if (_remoteRPCVersion >= SoapyRPCVersionRangeStep)
     {
         #ifdef SOAPY_SDR_API_HAS_RANGE_TYPE_STEP
         *this & value.step();
@@ -7,7 +7,7 @@
 #include <SoapySDR/Logger.hpp>
 #include <cstring> //strerror
 #include <cerrno> //errno
-#include <algorithm> //max
+#include <algorithm> //max, swap
 #include <mutex>
 
 static std::mutex sessionMutex;
@@ -116,6 +116,12 @@ int SoapyRPCSocket::close(void)
     return ret;
 }
 
+void SoapyRPCSocket::swap(SoapyRPCSocket &other)
+{
+    std::swap(_sock, other._sock);
+    std::swap(_lastErrorMsg, other._lastErrorMsg);
+}
+
 int SoapyRPCSocket::bind(const std::string &url)
 {
     SoapyURL urlObj(url);
@@ -477,6 +483,23 @@ bool SoapyRPCSocket::selectRecv(const long timeoutUs)
     return ret == 1;
 }
 
+bool SoapyRPCSocket::selectRecv(const long timeoutUs, const SoapyRPCSocket &wakeSock)
+{
+    struct timeval tv;
+    tv.tv_sec = timeoutUs / 1000000;
+    tv.tv_usec = timeoutUs % 1000000;
+
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(_sock, &readfds);
+    FD_SET(wakeSock._sock, &readfds);
+
+    int ret = ::select(std::max(_sock, wakeSock._sock)+1, &readfds, NULL, NULL, &tv);
+    if (ret == -1) this->reportError("select()");
+    if (ret <= 0 or FD_ISSET(wakeSock._sock, &readfds)) return false;
+    return FD_ISSET(_sock, &readfds) != 0;
+}
+
 int SoapyRPCSocket::selectRecvMultiple(const std::vector<SoapyRPCSocket *> &socks, std::vector<bool> &ready, const long timeoutUs)
 {
     struct timeval tv;
@@ -582,3 +605,16 @@ int SoapyRPCSocket::getBuffSize(const bool isRecv)
 
     return opt;
 }
+
+int SoapyRPCSocket::setNotSentLowat(const size_t numBytes)
+{
+    #ifdef TCP_NOTSENT_LOWAT
+    int opt = int(numBytes);
+    int ret = ::setsockopt(_sock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, (const char *)&opt, sizeof(opt));
+    if (ret == -1) this->reportError("setsockopt(TCP_NOTSENT_LOWAT)");
+    return ret;
+    #else
+    (void)numBytes;
+    return 0;
+    #endif //TCP_NOTSENT_LOWAT
+}
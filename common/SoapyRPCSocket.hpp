@@ -57,6 +57,12 @@ public:
      */
     int close(void);
 
+    /*!
+     * Exchange the underlying sockets with another socket object.
+     * Used to hand a connected socket over to a new owner.
+     */
+    void swap(SoapyRPCSocket &other);
+
     /*!
      * Server bind.
      * URL examples:
@@ -131,6 +137,13 @@ public:
      */
     bool selectRecv(const long timeoutUs);
 
+    /*!
+     * Wait for recv to become ready with timeout,
+     * or for the wake socket to become ready first.
+     * Return true for ready, false for timeout or wake.
+     */
+    bool selectRecv(const long timeoutUs, const SoapyRPCSocket &wakeSock);
+
     /*!
      * Wait for recv ready on multiple sockets.
      * Set the output ready vector to true for ready or false
@@ -172,6 +185,13 @@ public:
      */
     int getBuffSize(const bool isRecv);
 
+    /*!
+     * Limit the unsent bytes queued in the socket (TCP_NOTSENT_LOWAT).
+     * Sends block once the limit is reached, bounding the send latency.
+     * \return 0 for success (or not supported) or negative error code.
+     */
+    int setNotSentLowat(const size_t numBytes);
+
 private:
     int _sock;
     std::string _lastErrorMsg;
@@ -15,6 +15,9 @@
 #include <algorithm> //min, max
 #include <stdexcept>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <map>
 
 //! How long to wait for the server presence checks
 static const long SERVER_CHECK_TIMEOUT_US = 3000000; //3 seconds
@@ -30,35 +33,81 @@ static void testServerConnection(const std::string &url)
     s.selectRecv(SERVER_CHECK_TIMEOUT_US);
 }
 
+/***********************************************************************
+ * push handler registry
+ **********************************************************************/
+static std::mutex pushHandlersMutex;
+static std::map<std::pair<SoapyRPCSocket *, SoapyRemoteCalls>, SoapyRPCUnpacker::PushHandler> pushHandlers;
+static std::atomic<size_t> numPushHandlers(0); //skip the lookup when unused
+
+static SoapyRPCUnpacker::PushHandler getPushHandler(SoapyRPCSocket &sock, const SoapyRemoteCalls call)
+{
+    if (numPushHandlers.load() == 0) return SoapyRPCUnpacker::PushHandler();
+    std::lock_guard<std::mutex> lock(pushHandlersMutex);
+    const auto it = pushHandlers.find(std::make_pair(&sock, call));
+    if (it == pushHandlers.end()) return SoapyRPCUnpacker::PushHandler();
+    return it->second;
+}
+
+void SoapyRPCUnpacker::setPushHandler(SoapyRPCSocket &sock, const SoapyRemoteCalls call, const PushHandler &handler)
+{
+    std::lock_guard<std::mutex> lock(pushHandlersMutex);
+    if (handler) pushHandlers[std::make_pair(&sock, call)] = handler;
+    else pushHandlers.erase(std::make_pair(&sock, call));
+    numPushHandlers = pushHandlers.size();
+}
+
+void SoapyRPCUnpacker::recvPushes(SoapyRPCSocket &sock)
+{
+    while (sock.selectRecv(0))
+    {
+        SoapyRPCUnpacker unpacker(sock, false);
+        if (unpacker.recvMessage()) throw std::runtime_error("SoapyRPCUnpacker::recvPushes() FAIL: unexpected reply");
+    }
+}
+
+/***********************************************************************
+ * unpacker implementation
+ **********************************************************************/
 SoapyRPCUnpacker::SoapyRPCUnpacker(SoapyRPCSocket &sock, const bool autoRecv, const long timeoutUs):
     _sock(sock),
     _message(NULL),
     _offset(0),
     _capacity(0),
-    _remoteRPCVersion(SoapyRPCVersion)
+    _remoteRPCVersion(SoapyRPCVersion),
+    _heartbeat(false)
 {
     //auto recv expects a reply packet within a reasonable time window
     //or else the link might be down, in which case we throw an error.
     //Calls are allowed to take a long time (up to 31 seconds).
     //However, we continually check that the server is active
     //so that we can tear down immediately if the server goes away.
-    if (timeoutUs >= SERVER_CHECK_TIMEOUT_US)
+    //Servers that push heartbeats are alive while the heartbeats arrive,
+    //older servers are checked with a test connection instead.
+    //Pushed messages before the reply are handled and the wait continues.
+    const auto exitTime = std::chrono::high_resolution_clock::now() + std::chrono::microseconds(timeoutUs);
+    while (true)
     {
-        const auto exitTime = std::chrono::high_resolution_clock::now() + std::chrono::microseconds(timeoutUs);
-        while (not _sock.selectRecv(SERVER_CHECK_TIMEOUT_US))
+        if (timeoutUs >= SERVER_CHECK_TIMEOUT_US)
         {
-            testServerConnection(_sock.getpeername());
-            if (std::chrono::high_resolution_clock::now() > exitTime)
-                throw std::runtime_error("SoapyRPCUnpacker::recv() TIMEOUT");
+            while (not _sock.selectRecv(_heartbeat?SOAPY_REMOTE_HEARTBEAT_TIMEOUT_US:SERVER_CHECK_TIMEOUT_US))
+            {
+                if (_heartbeat) throw std::runtime_error("SoapyRPCUnpacker::recv() FAIL: lost server heartbeat");
+                testServerConnection(_sock.getpeername());
+                if (std::chrono::high_resolution_clock::now() > exitTime)
+                    throw std::runtime_error("SoapyRPCUnpacker::recv() TIMEOUT");
+            }
+        }
+        //small timeout but not -1 for infinite timeout
+        else if (timeoutUs >= 0 and not _sock.selectRecv(timeoutUs))
+        {
+            throw std::runtime_error("SoapyRPCUnpacker::recv() TIMEOUT");
         }
-    }
-    //small timeout but not -1 for infinite timeout
-    else if (timeoutUs >= 0 and not _sock.selectRecv(timeoutUs))
-    {
-        throw std::runtime_error("SoapyRPCUnpacker::recv() TIMEOUT");
-    }
 
-    if (autoRecv) this->recv();
+        if (not autoRecv or this->recvMessage()) break;
+        if (timeoutUs >= 0 and std::chrono::high_resolution_clock::now() > exitTime)
+            throw std::runtime_error("SoapyRPCUnpacker::recv() TIMEOUT");
+    }
 }
 
 SoapyRPCUnpacker::~SoapyRPCUnpacker(void)
@@ -74,6 +123,16 @@ SoapyRPCUnpacker::~SoapyRPCUnpacker(void)
 
 void SoapyRPCUnpacker::recv(void)
 {
+    while (not this->recvMessage()) {}
+}
+
+bool SoapyRPCUnpacker::recvMessage(void)
+{
+    //a previous pushed message is replaced
+    free(_message);
+    _message = NULL;
+    _offset = 0;
+
     //receive the header
     SoapyRPCHeader header;
     int ret = _sock.recv(&header, sizeof(header), MSG_WAITALL);
@@ -119,6 +178,29 @@ void SoapyRPCUnpacker::recv(void)
         throw std::runtime_error("SoapyRPCUnpacker::recv() FAIL: trailer word");
     }
 
+    //heartbeats only show that the server is alive,
+    //other pushed messages go to the socket's handler,
+    //fields the handler does not know are skipped
+    if (this->peekType() == SOAPY_REMOTE_CALL)
+    {
+        const size_t callOffset = _offset;
+        SoapyRemoteCalls call;
+        *this & call;
+        if (call == SOAPY_REMOTE_HEARTBEAT) _heartbeat = true;
+        else
+        {
+            const auto pushHandler = getPushHandler(_sock, call);
+            if (not pushHandler)
+            {
+                _offset = callOffset; //a request, not a push
+                return true;
+            }
+            pushHandler(*this);
+        }
+        _offset = _capacity - sizeof(SoapyRPCTrailer);
+        return false;
+    }
+
     //auto-consume void
     if (this->peekType() == SOAPY_REMOTE_VOID)
     {
@@ -135,6 +217,7 @@ void SoapyRPCUnpacker::recv(void)
         *this & errorMsg;
         throw std::runtime_error("RemoteError: "+errorMsg);
     }
+    return true;
 }
 
 void SoapyRPCUnpacker::unpack(void *buff, const size_t length)
@@ -231,8 +314,8 @@ void SoapyRPCUnpacker::operator&(SoapySDR::Range &value)
     *this & minimum;
     *this & maximum;
 
-    //a step size is sent when the remote version matches our current
-    if (_remoteRPCVersion >= SoapyRPCVersion)
+    //a step size is sent when the remote version supports it
+    if (_remoteRPCVersion >= SoapyRPCVersionRangeStep)
     {
         *this & step;
     }
@@ -4,6 +4,7 @@
 #pragma once
 #include "SoapyRemoteConfig.hpp"
 #include <SoapySDR/Types.hpp>
+#include <functional>
 #include <vector>
 #include <complex>
 #include <string>
@@ -24,6 +25,21 @@ public:
     //! Receive a complete RPC message
     void recv(void);
 
+    /*!
+     * Pushed messages arrive on a socket between replies and start
+     * with a call, the handler unpacks the rest of the message.
+     * Unpackers on the socket hand them to the handler for the call
+     * and keep waiting. An empty handler removes the registration.
+     */
+    typedef std::function<void(SoapyRPCUnpacker &)> PushHandler;
+    static void setPushHandler(SoapyRPCSocket &sock, const SoapyRemoteCalls call, const PushHandler &handler);
+
+    /*!
+     * Receive the pushed messages that are waiting on the socket.
+     * Call this while no reply is expected; throws on other messages.
+     */
+    static void recvPushes(SoapyRPCSocket &sock);
+
     //! Unpack a binary blob of known size
     void unpack(void *buff, const size_t length);
 
@@ -114,9 +130,13 @@ private:
 
     void ensureSpace(const size_t length);
 
+    //receive one message, return false when it was a handled push
+    bool recvMessage(void);
+
     SoapyRPCSocket &_sock;
     char *_message;
     size_t _offset;
     size_t _capacity;
     unsigned int _remoteRPCVersion;
+    bool _heartbeat; //the server pushed a heartbeat during the wait
 };
@@ -26,6 +26,16 @@
 //! Stream args key to select the stream's protocol (tcp or udp)
 #define SOAPY_REMOTE_KWARG_PROT (SOAPY_REMOTE_KWARG_PREFIX "prot")
 
+/*!
+ * Stream args key to stripe a tcp stream across several connections.
+ * Frames are sent round-robin by sequence number on each connection,
+ * so the receiver merges them in order by reading each in turn.
+ */
+#define SOAPY_REMOTE_KWARG_STRIPES (SOAPY_REMOTE_KWARG_PREFIX "stripes")
+
+//! Upper limit for the number of tcp stream connections
+#define SOAPY_REMOTE_MAX_STRIPES 16
+
 /*!
  * Default stream transfer size (under network MTU).
  * Larger transfer sizes may not be supported in hardware
@@ -33,6 +43,19 @@
  */
 #define SOAPY_REMOTE_DEFAULT_ENDPOINT_MTU 1500
 
+/*!
+ * Default stream transfer size for the TCP protocol.
+ * TCP frames are not limited by the network MTU,
+ * large frames amortize the per-frame header and socket calls.
+ */
+#define SOAPY_REMOTE_DEFAULT_TCP_ENDPOINT_MTU (256*1024)
+
+/*!
+ * Unsent bytes allowed in a TCP stream socket, in frames.
+ * This bounds the send latency (TCP_NOTSENT_LOWAT).
+ */
+#define SOAPY_REMOTE_TCP_NOTSENT_FRAMES 2
+
 /*!
  * Stream args key to set the very large socket buffer size in bytes.
  * This sets the socket buffer size as well as the flow control window.
@@ -59,6 +82,115 @@
 //! Default thread priority is elevated for stream forwarding
 #define SOAPY_REMOTE_DEFAULT_THREAD_PRIORITY double(0.5)
 
+/*!
+ * Stream args key to enable the client's receive prefetch thread.
+ * The value is the size in bytes of the user-space ring that the
+ * thread drains the stream socket into (0 disables prefetching).
+ * When the application falls behind, the ring drops whole packets
+ * and readStream reports SOAPY_SDR_OVERFLOW once space frees up.
+ */
+#define SOAPY_REMOTE_KWARG_PREFETCH (SOAPY_REMOTE_KWARG_PREFIX "prefetch")
+
+/*!
+ * Stream args key to enable the client's transmit send thread.
+ * The value is the size in bytes of the user-space queue that
+ * writeStream fills; the send thread waits on flow control and
+ * drains the queue into the stream socket (0 disables the queue).
+ */
+#define SOAPY_REMOTE_KWARG_QUEUE (SOAPY_REMOTE_KWARG_PREFIX "queue")
+
+//! The minimum number of packets held by the prefetch ring and send queue
+#define SOAPY_REMOTE_RING_MIN_SLOTS 8
+
+/*!
+ * Stream args key to activate the stream as part of its setup (set to "true").
+ * The server activates the stream in the same exchange that creates it,
+ * and the application's first activateStream() call without arguments
+ * is then handled locally by the client.
+ */
+#define SOAPY_REMOTE_KWARG_ACTIVATE (SOAPY_REMOTE_KWARG_PREFIX "activate")
+
+/*!
+ * Stream args keys to enable the server's transmit jitter buffer.
+ * Prefill is in elements and latency is in microseconds (the larger wins).
+ * The server holds the device writes of each burst until the buffer
+ * reaches the target, raises the target when the buffer runs dry,
+ * and reports SOAPY_SDR_UNDERFLOW to the client's stream status.
+ */
+#define SOAPY_REMOTE_KWARG_PREFILL (SOAPY_REMOTE_KWARG_PREFIX "prefill")
+#define SOAPY_REMOTE_KWARG_LATENCY (SOAPY_REMOTE_KWARG_PREFIX "latency")
+
+//! Limit for the adaptive jitter buffer target (multiple of the configured fill)
+#define SOAPY_REMOTE_JITTER_MAX_GROWTH 4
+
+//! Lower the jitter buffer target after this many packets without running dry
+#define SOAPY_REMOTE_JITTER_ADAPT_PACKETS 10000
+
+//! Poll interval while the jitter buffer is filling
+#define SOAPY_REMOTE_JITTER_POLL_US 1000
+
+/*!
+ * Stream args key to keep a history of a receive stream on the server.
+ * The value is the number of seconds of samples to hold in memory (0 disables).
+ */
+#define SOAPY_REMOTE_KWARG_HISTORY (SOAPY_REMOTE_KWARG_PREFIX "history")
+
+/*!
+ * Stream args key to setup a replay stream (set to "true").
+ * A replay stream reads windows of samples out of the history
+ * of a receive stream with the same channels and remote format.
+ */
+#define SOAPY_REMOTE_KWARG_REPLAY (SOAPY_REMOTE_KWARG_PREFIX "replay")
+
+/*!
+ * Channel setting key to record a receive channel on the server.
+ * Write a path to start a SigMF recording of the channel's stream,
+ * write an empty value to stop, and read the key for statistics.
+ */
+#define SOAPY_REMOTE_KWARG_RECORD (SOAPY_REMOTE_KWARG_PREFIX "record")
+
+/*!
+ * Stream args key to setup a record-only receive stream (set to "true").
+ * The server reads the device on its own thread for the recordings,
+ * and no samples are sent to the client.
+ */
+#define SOAPY_REMOTE_KWARG_RECORD_ONLY (SOAPY_REMOTE_KWARG_PREFIX "record_only")
+
+/*!
+ * Stream args key to upload a named waveform into the server's cache.
+ * The transmit stream buffers samples locally and uploads them
+ * in a single call at the end of the burst (or on close).
+ */
+#define SOAPY_REMOTE_KWARG_WAVEFORM (SOAPY_REMOTE_KWARG_PREFIX "waveform")
+
+/*!
+ * Channel setting key to play a cached waveform on a transmit channel.
+ * The value is markup: name=waveform, repeat=count (0 loops), time=ns.
+ * Write an empty value to end the playback after the current repetition.
+ */
+#define SOAPY_REMOTE_KWARG_PLAY (SOAPY_REMOTE_KWARG_PREFIX "play")
+
+/*!
+ * Log forwarding args: the number of messages queued for a client,
+ * and the message to drop when the queue is full ("oldest" or "newest").
+ * The server reports the number of dropped messages to the client.
+ */
+#define SOAPY_REMOTE_KWARG_LOG_QUEUE (SOAPY_REMOTE_KWARG_PREFIX "log_queue")
+#define SOAPY_REMOTE_KWARG_LOG_DROP (SOAPY_REMOTE_KWARG_PREFIX "log_drop")
+
+//! The default number of log messages queued for each client
+#define SOAPY_REMOTE_LOG_QUEUE_SIZE 1024
+
+//! The number of log messages held between the log callback and the dispatcher
+#define SOAPY_REMOTE_LOG_RING_SIZE 4096
+
+/*!
+ * The server counts the overflow, underflow, and sequence markers
+ * (SOAPY_SDR_SSI level) over this interval and forwards a summary
+ * like "S x1532 in 100ms" rather than one message per marker.
+ */
+#define SOAPY_REMOTE_LOG_SSI_INTERVAL_US (100*1000) //100 ms
+
 /***********************************************************************
  * Socket defaults
  **********************************************************************/
@@ -69,6 +201,90 @@
 //! Use this timeout for every socket poll loop
 #define SOAPY_REMOTE_SOCKET_TIMEOUT_US (100*1000) //100 ms
 
+//! Timeout for driver calls in the server stream threads (bounds the stop time)
+#define SOAPY_REMOTE_DEVICE_TIMEOUT_US (10*1000) //10 ms
+
+/*!
+ * The server pushes heartbeats on the control socket at this period
+ * while a call is in progress, so the client can tell a slow call
+ * from a lost server without opening probe connections.
+ * The client gives up on a call after this long without a heartbeat.
+ */
+#define SOAPY_REMOTE_HEARTBEAT_PERIOD_US (1000*1000) //1 s
+#define SOAPY_REMOTE_HEARTBEAT_TIMEOUT_US (3*1000*1000) //3 s
+
+/*!
+ * The number of stream and status socket pairs kept per connection.
+ * Closed datagram streams return their bound sockets to the pool,
+ * so scanning applications that reopen streams reuse the sockets.
+ */
+#define SOAPY_REMOTE_SOCKET_POOL_SIZE 4
+
+/*!
+ * The client keeps idle server connections for reuse by discovery,
+ * device make, and log acceptance: at most this many per server URL,
+ * each for at most this long before the connection is closed.
+ */
+#define SOAPY_REMOTE_CONNECTION_POOL_SIZE 2
+#define SOAPY_REMOTE_CONNECTION_TTL_US (30*1000*1000) //30 s
+
+/*!
+ * The client caches the devices enumerated on each server.
+ * Results are fresh for the time in the "remote:cache" enumeration arg
+ * (in seconds, 0 disables the cache) and stale results are refreshed
+ * in the background until they expire at the maximum age.
+ */
+#define SOAPY_REMOTE_ENUMERATE_CACHE_FRESH_US (1*1000*1000) //1 s
+#define SOAPY_REMOTE_ENUMERATE_CACHE_MAX_AGE_US (60*1000*1000) //60 s
+
+/*!
+ * The client models the remote hardware clock when the device args
+ * contain "remote:clock" (the sample period in seconds).
+ * getHardwareTime() is answered locally while the model's error bound
+ * is within "remote:clock_tolerance" (in ns), otherwise with a call.
+ */
+#define SOAPY_REMOTE_CLOCK_TOLERANCE_NS (100*1000) //100 us
+#define SOAPY_REMOTE_CLOCK_MIN_SAMPLES 4
+#define SOAPY_REMOTE_CLOCK_MAX_SAMPLES 16
+
+//! Samples with a round trip over twice the best plus this are not fitted
+#define SOAPY_REMOTE_CLOCK_RTT_SLACK_NS (50*1000) //50 us
+
+//! The model is not used when the newest sample is older than this many periods
+#define SOAPY_REMOTE_CLOCK_MAX_AGE_PERIODS 2
+
+/*!
+ * Sensor subscriptions: writing the setting "remote:subscribe:<sensor>"
+ * (or the channel setting for channel sensors) with a period in seconds
+ * makes the server push the sensor's value at that period; 0 stops it.
+ * The setting "remote:subscribe_time" subscribes to the hardware time.
+ * Reads are answered from the pushed value while it is fresh.
+ */
+#define SOAPY_REMOTE_KWARG_SUBSCRIBE (SOAPY_REMOTE_KWARG_PREFIX "subscribe:")
+#define SOAPY_REMOTE_KWARG_SUBSCRIBE_TIME (SOAPY_REMOTE_KWARG_PREFIX "subscribe_time")
+
+//! Pushed values are fresh for this many subscription periods
+#define SOAPY_REMOTE_SUBSCRIBE_FRESH_PERIODS 2
+
+//! The shortest subscription period accepted by the server
+#define SOAPY_REMOTE_SUBSCRIBE_MIN_PERIOD_US (1000) //1 ms
+
+/*!
+ * The "remotecluster" driver combines one remote device per URL
+ * (separated by spaces in the "remote:cluster" arg) into one device.
+ * Received streams are aligned by hardware timestamp,
+ * node times further apart than the skew are reported as time errors.
+ */
+#define SOAPY_REMOTE_KWARG_CLUSTER (SOAPY_REMOTE_KWARG_PREFIX "cluster")
+#define SOAPY_REMOTE_CLUSTER_MAX_SKEW_NS (1000*1000*1000LL) //1 s
+
+/*!
+ * The server caches enumerate results shared by all clients.
+ * Results expire after the TTL (SoapySDRServer --enumerate-ttl)
+ * and are invalidated on device make/unmake and hotplug events.
+ */
+#define SOAPY_REMOTE_SERVER_ENUMERATE_TTL_US (2*1000*1000) //2 s
+
 //! Backlog count for the server socket listen
 #define SOAPY_REMOTE_LISTEN_BACKLOG 100
 
@@ -101,7 +317,28 @@
  **********************************************************************/
 //major, minor, patch when this was last updated
 //bump the version number when changes are made
-static const unsigned int SoapyRPCVersion = 0x000400;
+static const unsigned int SoapyRPCVersion = 0x000500;
+
+//first version to send the step size with the range type
+static const unsigned int SoapyRPCVersionRangeStep = 0x000400;
+
+//first version to support the negotiated stream setup call
+static const unsigned int SoapyRPCVersionNegotiate = 0x000500;
+
+//first version to support the multiplexed stream status channel
+static const unsigned int SoapyRPCVersionStatusChannel = 0x000500;
+
+//first version to accept striped tcp stream connections
+static const unsigned int SoapyRPCVersionStripes = 0x000500;
+
+//first version to push subscribed sensor updates on the control socket
+static const unsigned int SoapyRPCVersionPush = 0x000500;
+
+//first version to push heartbeats during calls on the control socket
+static const unsigned int SoapyRPCVersionHeartbeat = 0x000500;
+
+//first version to push forwarded log messages on the control socket
+static const unsigned int SoapyRPCVersionLogPush = 0x000500;
 
 enum SoapyRemoteTypes
 {
@@ -134,11 +371,13 @@ enum SoapyRemoteCalls
     SOAPY_REMOTE_MAKE            = 1,
     SOAPY_REMOTE_UNMAKE          = 2,
     SOAPY_REMOTE_HANGUP          = 3,
+    SOAPY_REMOTE_HEARTBEAT       = 4, //pushed by the server
 
     //logger
     SOAPY_REMOTE_GET_SERVER_ID          = 20,
     SOAPY_REMOTE_START_LOG_FORWARDING   = 21,
     SOAPY_REMOTE_STOP_LOG_FORWARDING    = 22,
+    SOAPY_REMOTE_PUSH_LOG               = 23, //pushed by the server
 
     //identification
     SOAPY_REMOTE_GET_DRIVER_KEY      = 100,
@@ -161,6 +400,14 @@ enum SoapyRemoteCalls
     SOAPY_REMOTE_GET_NATIVE_STREAM_FORMAT  = 305,
     SOAPY_REMOTE_GET_STREAM_ARGS_INFO      = 306,
     SOAPY_REMOTE_SETUP_STREAM_BYPASS       = 307,
+    SOAPY_REMOTE_REPLAY_STREAM_HISTORY     = 308,
+    SOAPY_REMOTE_START_RECORDING           = 309,
+    SOAPY_REMOTE_STOP_RECORDING            = 310,
+    SOAPY_REMOTE_GET_RECORDING_STATUS      = 311,
+    SOAPY_REMOTE_UPLOAD_WAVEFORM           = 312,
+    SOAPY_REMOTE_PLAY_WAVEFORM             = 313,
+    SOAPY_REMOTE_SETUP_STREAM_NEGOTIATE    = 314,
+    SOAPY_REMOTE_SETUP_STATUS_CHANNEL      = 315,
 
     //antenna
     SOAPY_REMOTE_LIST_ANTENNAS      = 500,
@@ -239,6 +486,8 @@ enum SoapyRemoteCalls
     SOAPY_REMOTE_READ_CHANNEL_SENSOR     = 1203,
     SOAPY_REMOTE_GET_SENSOR_INFO         = 1204,
     SOAPY_REMOTE_GET_CHANNEL_SENSOR_INFO = 1205,
+    SOAPY_REMOTE_SUBSCRIBE               = 1206,
+    SOAPY_REMOTE_PUSH_SENSOR             = 1207, //pushed by the server
 
     //registers
     SOAPY_REMOTE_WRITE_REGISTER            = 1300,
@@ -20,11 +20,13 @@
 #include <memory> //unique_ptr
 #include <vector>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
 #include <ctime>
 #include <cerrno>
 #include <chrono>
 #include <cctype>
+#include <algorithm> //min
 #include <map>
 #include <set>
 
@@ -52,6 +54,9 @@
 //! Service stopped, use with multicast NOTIFY
 #define NTS_BYEBYE "ssdp:byebye"
 
+//! Header field for the server's configuration ID (UPnP 1.1)
+#define CONFIGID_FIELD "CONFIGID.UPNP.ORG"
+
 /***********************************************************************
  * Utility functions
  **********************************************************************/
@@ -80,7 +85,8 @@ struct SoapySSDPEndpointImpl
 {
     SoapySSDPEndpointImpl(void):
         thread(nullptr),
-        done(false)
+        done(false),
+        numRegistered(0)
     {
         return;
     }
@@ -102,6 +108,13 @@ struct SoapySSDPEndpointImpl
     //active USNs per IP version
     typedef std::map<std::string, std::pair<std::string, std::chrono::high_resolution_clock::time_point>> DiscoveredURLs;
     std::map<int, DiscoveredURLs> usnToURL;
+
+    //configuration ID per USN (when advertised)
+    std::map<std::string, std::string> usnToConfigId;
+
+    //count registrations to know when search replies settle
+    size_t numRegistered;
+    std::condition_variable registeredCond;
 };
 
 /***********************************************************************
@@ -170,6 +183,7 @@ SoapySSDPEndpointData *SoapySSDPEndpointData::setupSocket(const std::string &bin
 SoapySSDPEndpoint::SoapySSDPEndpoint(void):
     _impl(new SoapySSDPEndpointImpl()),
     serviceIpVer(SOAPY_REMOTE_IPVER_NONE),
+    configId(0),
     periodicSearchEnabled(false),
     periodicNotifyEnabled(false)
 {
@@ -224,10 +238,24 @@ std::map<std::string, std::map<int, std::string>> SoapySSDPEndpoint::getServerUR
         this->periodicSearchEnabled = true;
         for (auto &data : _impl->handlers) this->sendSearchHeader(data);
 
-        //wait maximum timeout for replies
-        lock.unlock();
-        std::this_thread::sleep_for(std::chrono::microseconds(timeoutUs));
-        lock.lock();
+        //wait maximum timeout for replies, but stop early once
+        //replies arrived and no new server replied for a while
+        const auto settle = std::chrono::microseconds(timeoutUs/4);
+        const auto exitTime = std::chrono::high_resolution_clock::now() + std::chrono::microseconds(timeoutUs);
+        auto lastChange = std::chrono::high_resolution_clock::now();
+        size_t lastCount = _impl->numRegistered;
+        size_t numReplies = 0;
+        while (true)
+        {
+            auto waitTime = exitTime;
+            if (numReplies != 0) waitTime = std::min(waitTime, lastChange + settle);
+            if (_impl->registeredCond.wait_until(lock, waitTime) == std::cv_status::timeout and
+                std::chrono::high_resolution_clock::now() >= waitTime) break;
+            if (_impl->numRegistered == lastCount) continue; //spurious
+            numReplies += _impl->numRegistered - lastCount;
+            lastCount = _impl->numRegistered;
+            lastChange = std::chrono::high_resolution_clock::now();
+        }
     }
 
     std::map<std::string, std::map<int, std::string>> serverUrls;
@@ -244,6 +272,28 @@ std::map<std::string, std::map<int, std::string>> SoapySSDPEndpoint::getServerUR
     return serverUrls;
 }
 
+std::map<std::string, std::string> SoapySSDPEndpoint::getServerConfigIds(void)
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+
+    std::map<std::string, std::string> configIds;
+    for (const auto &pair : _impl->usnToConfigId)
+    {
+        configIds[uuidFromUSN(pair.first)] = pair.second;
+    }
+    return configIds;
+}
+
+void SoapySSDPEndpoint::setConfigId(const unsigned configId)
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    if (this->configId == configId) return;
+    this->configId = configId;
+
+    //tell the clients right away rather than at the next periodic notify
+    if (this->periodicNotifyEnabled) for (auto &data : _impl->handlers) this->sendNotifyHeader(data, NTS_ALIVE);
+}
+
 void SoapySSDPEndpoint::handlerLoop(void)
 {
     std::string recvAddr;
@@ -300,7 +350,11 @@ void SoapySSDPEndpoint::handlerLoop(void)
             {
                 auto &expires = it->second.second;
                 if (expires > timeNow) ++it;
-                else usnToURL.erase(it++);
+                else
+                {
+                    _impl->usnToConfigId.erase(it->first);
+                    usnToURL.erase(it++);
+                }
             }
         }
 
@@ -367,6 +421,7 @@ void SoapySSDPEndpoint::sendNotifyHeader(SoapySSDPEndpointData *data, const std:
     {
         header.addField("CACHE-CONTROL", "max-age=" + std::to_string(CACHE_DURATION_SECONDS));
         header.addField("LOCATION", SoapyURL("tcp", SoapyInfo::getHostName(), service).toString());
+        if (configId != 0) header.addField(CONFIGID_FIELD, std::to_string(configId));
     }
     header.addField("SERVER", SoapyInfo::getUserAgent());
     header.addField("NT", SOAPY_REMOTE_TARGET);
@@ -392,6 +447,7 @@ void SoapySSDPEndpoint::handleSearchRequest(SoapySSDPEndpointData *data, const S
     response.addField("DATE", timeNowGMT());
     response.addField("EXT", "");
     response.addField("LOCATION", SoapyURL("tcp", SoapyInfo::getHostName(), service).toString());
+    if (configId != 0) response.addField(CONFIGID_FIELD, std::to_string(configId));
     response.addField("SERVER", SoapyInfo::getUserAgent());
     response.addField("ST", SOAPY_REMOTE_TARGET);
     response.addField("USN", "uuid:"+uuid+"::"+SOAPY_REMOTE_TARGET);
@@ -447,6 +503,7 @@ void SoapySSDPEndpoint::handleRegisterService(SoapySSDPEndpointData *data, const
         auto &usnToURL = _impl->usnToURL[data->ipVer];
         SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapySSDP removed %s [%s] %s IPv%d", usnToURL[usn].first.c_str(), uuidFromUSN(usn).c_str(), data->ethName.c_str(), data->ipVer);
         usnToURL.erase(usn);
+        _impl->usnToConfigId.erase(usn);
         return;
     }
 
@@ -459,4 +516,8 @@ void SoapySSDPEndpoint::handleRegisterService(SoapySSDPEndpointData *data, const
     //register the server
     const auto expires = std::chrono::high_resolution_clock::now() + std::chrono::seconds(getCacheDuration(header));
     _impl->usnToURL[data->ipVer][usn] = std::make_pair(serverURL.toString(), expires);
+    const auto configIdField = header.getField(CONFIGID_FIELD);
+    if (not configIdField.empty()) _impl->usnToConfigId[usn] = configIdField;
+    _impl->numRegistered++;
+    _impl->registeredCond.notify_all();
 }
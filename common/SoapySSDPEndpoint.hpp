@@ -32,6 +32,13 @@ public:
      */
     void registerService(const std::string &uuid, const std::string &service, const int ipVer);
 
+    /*!
+     * Advertise a new configuration ID for the registered service.
+     * Clients use the ID (CONFIGID.UPNP.ORG) to detect that the
+     * server's devices changed; 0 disables the field (the default).
+     */
+    void setConfigId(const unsigned configId);
+
     /*!
      * Get a list of all active server URLs.
      * \param ipVer the preferred IP version to discover
@@ -39,6 +46,12 @@ public:
      */
     std::map<std::string, std::map<int, std::string>> getServerURLs(const int ipVer, const long timeoutUs);
 
+    /*!
+     * Get the configuration IDs advertised by the active servers.
+     * \return a mapping of server UUIDs to configuration IDs
+     */
+    std::map<std::string, std::string> getServerConfigIds(void);
+
 private:
     SoapySSDPEndpointImpl *_impl;
 
@@ -46,6 +59,7 @@ private:
     int serviceIpVer;
     std::string uuid;
     std::string service;
+    unsigned configId;
 
     //configured messages
     bool periodicSearchEnabled;
@@ -0,0 +1,100 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "SoapySocketPool.hpp"
+#include "SoapyRPCSocket.hpp"
+#include <SoapySDR/Logger.hpp>
+
+SoapySocketPool::SoapySocketPool(const size_t maxPairs):
+    _maxPairs(maxPairs)
+{
+    return;
+}
+
+SoapySocketPool::~SoapySocketPool(void)
+{
+    for (auto sock : _streamSocks) delete sock;
+    for (auto sock : _statusSocks) delete sock;
+}
+
+static void drainSocket(SoapyRPCSocket &sock)
+{
+    //discard datagrams left over from the previous stream
+    char buff[1024];
+    size_t count = 0;
+    while (not sock.null() and sock.selectRecv(0))
+    {
+        if (sock.recv(buff, sizeof(buff)) < 0) break;
+        count++;
+    }
+    if (count != 0) SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapySocketPool drained %d stale datagrams", int(count));
+}
+
+static SoapyRPCSocket *takeSocket(std::vector<SoapyRPCSocket *> &socks)
+{
+    if (socks.empty()) return new SoapyRPCSocket();
+    auto sock = socks.back();
+    socks.pop_back();
+    return sock;
+}
+
+void SoapySocketPool::acquire(SoapyRPCSocket *&streamSock, SoapyRPCSocket *&statusSock)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        streamSock = takeSocket(_streamSocks);
+        statusSock = takeSocket(_statusSocks);
+    }
+
+    drainSocket(*streamSock);
+    drainSocket(*statusSock);
+}
+
+void SoapySocketPool::acquire(SoapyRPCSocket *&streamSock)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        streamSock = takeSocket(_streamSocks);
+    }
+
+    drainSocket(*streamSock);
+}
+
+void SoapySocketPool::release(SoapyRPCSocket *streamSock, SoapyRPCSocket *statusSock)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_streamSocks.size() < _maxPairs)
+        {
+            _streamSocks.push_back(streamSock);
+            streamSock = nullptr;
+        }
+        else _sizedWindows.erase(streamSock);
+        if (statusSock != nullptr and _statusSocks.size() < _maxPairs)
+        {
+            _statusSocks.push_back(statusSock);
+            statusSock = nullptr;
+        }
+    }
+
+    delete streamSock;
+    delete statusSock;
+}
+
+int SoapySocketPool::getSizedWindow(SoapyRPCSocket *streamSock, const bool isRecv, const size_t window)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _sizedWindows.find(streamSock);
+    if (it == _sizedWindows.end()) return -1;
+    if (it->second.isRecv != isRecv or it->second.window != window) return -1;
+    return it->second.actualWindow;
+}
+
+void SoapySocketPool::setSizedWindow(SoapyRPCSocket *streamSock, const bool isRecv, const size_t window, const int actualWindow)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &sized = _sizedWindows[streamSock];
+    sized.isRecv = isRecv;
+    sized.window = window;
+    sized.actualWindow = actualWindow;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "SoapyRemoteConfig.hpp"
+#include <cstddef>
+#include <vector>
+#include <mutex>
+#include <map>
+
+class SoapyRPCSocket;
+
+/*!
+ * A small pool of datagram socket pairs for stream endpoints.
+ * Released pairs keep their bound ports and sized kernel buffers,
+ * so the next stream on the same connection skips that setup.
+ * The pool records the size of each stream socket when it is first
+ * sized, and later endpoints with the same window skip the resize.
+ * Stale datagrams are drained before a pair is handed out again.
+ */
+class SOAPY_REMOTE_API SoapySocketPool
+{
+public:
+    SoapySocketPool(const size_t maxPairs);
+
+    ~SoapySocketPool(void);
+
+    /*!
+     * Get a stream and status socket pair.
+     * Reused sockets may already be bound (non null),
+     * new sockets are null and must be bound or connected.
+     */
+    void acquire(SoapyRPCSocket *&streamSock, SoapyRPCSocket *&statusSock);
+
+    //! Get a stream socket only (the status is sent on a status channel)
+    void acquire(SoapyRPCSocket *&streamSock);
+
+    /*!
+     * Return datagram sockets for reuse (the status socket may be null).
+     * The sockets are deleted when the pool is full.
+     */
+    void release(SoapyRPCSocket *streamSock, SoapyRPCSocket *statusSock);
+
+    /*!
+     * Get the kernel buffer size of a stream socket from this pool
+     * that was already sized for the direction and window.
+     * Return -1 when the socket has not been sized yet.
+     */
+    int getSizedWindow(SoapyRPCSocket *streamSock, const bool isRecv, const size_t window);
+
+    //! Record the kernel buffer size of a stream socket after sizing it
+    void setSizedWindow(SoapyRPCSocket *streamSock, const bool isRecv, const size_t window, const int actualWindow);
+
+private:
+    const size_t _maxPairs;
+    std::mutex _mutex;
+    std::vector<SoapyRPCSocket *> _streamSocks;
+    std::vector<SoapyRPCSocket *> _statusSocks;
+
+    struct SizedWindow
+    {
+        bool isRecv;
+        size_t window;
+        int actualWindow;
+    };
+    std::map<SoapyRPCSocket *, SizedWindow> _sizedWindows;
+};
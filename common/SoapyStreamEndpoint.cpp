@@ -5,6 +5,7 @@
 #include <SoapySDR/Logger.hpp>
 #include "SoapyStreamEndpoint.hpp"
 #include "SoapyRPCSocket.hpp"
+#include "SoapySocketPool.hpp"
 #include "SoapyURLUtils.hpp"
 #include "SoapyRemoteDefs.hpp"
 #include "SoapySocketDefs.hpp"
@@ -26,6 +27,12 @@ struct StreamDatagramHeader
     long long time; //!< time associated with this datagram
 };
 
+struct StatusChannelDatagram
+{
+    StreamDatagramHeader header;
+    uint32_t streamId; //!< stream ID on the status channel
+};
+
 SoapyStreamEndpoint::SoapyStreamEndpoint(
     SoapyRPCSocket &streamSock,
     SoapyRPCSocket &statusSock,
@@ -34,9 +41,13 @@ SoapyStreamEndpoint::SoapyStreamEndpoint(
     const size_t numChans,
     const size_t elemSize,
     const size_t mtu,
-    const size_t window):
+    const size_t window,
+    SoapySocketPool *socketPool):
     _streamSock(streamSock),
     _statusSock(statusSock),
+    _wakeSock(new SoapyRPCSocket()),
+    _statusChannel(nullptr),
+    _statusStreamId(-1),
     _datagramMode(datagramMode),
     _xferSize(mtu-PROTO_HEADER_SIZE),
     _numChans(numChans),
@@ -53,6 +64,10 @@ SoapyStreamEndpoint::SoapyStreamEndpoint(
     _triggerAckWindow(0)
 {
     assert(not _streamSock.null());
+    _stripeSocks.push_back(&_streamSock);
+    _isRecv = isRecv;
+    _mtu = mtu;
+    _window = window;
 
     //allocate buffer data and default state
     _buffData.resize(_numBuffs);
@@ -68,29 +83,50 @@ SoapyStreamEndpoint::SoapyStreamEndpoint(
         }
     }
 
-    //endpoints require a large socket buffer in the data direction
-    int ret = _streamSock.setBuffSize(isRecv, window);
-    if (ret != 0)
-    {
-        SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint resize socket buffer to %d KiB failed\n  %s", int(window/1024), _streamSock.lastErrorMsg());
-    }
-
-    //log when the size is not expected, users may have to tweak system parameters
-    int actualWindow = _streamSock.getBuffSize(isRecv);
+    //a pooled socket keeps the size from the endpoint that sized it
+    int actualWindow = (socketPool == nullptr)?-1:socketPool->getSizedWindow(&_streamSock, isRecv, window);
     if (actualWindow < 0)
     {
-        SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint get socket buffer size failed\n  %s", _streamSock.lastErrorMsg());
-        actualWindow = window;
-    }
-    else if (size_t(actualWindow) < window)
-    {
-        SoapySDR::logf(SOAPY_SDR_WARNING, "StreamEndpoint resize socket buffer: set %d KiB, got %d KiB", int(window/1024), int(actualWindow/1024));
+        //endpoints require a large socket buffer in the data direction
+        int ret = _streamSock.setBuffSize(isRecv, window);
+        if (ret != 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint resize socket buffer to %d KiB failed\n  %s", int(window/1024), _streamSock.lastErrorMsg());
+        }
+
+        //bound the unsent data of a tcp sender to a few frames
+        if (not _datagramMode and not isRecv and _streamSock.setNotSentLowat(SOAPY_REMOTE_TCP_NOTSENT_FRAMES*mtu) != 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_WARNING, "StreamEndpoint set unsent limit failed\n  %s", _streamSock.lastErrorMsg());
+        }
+
+        //log when the size is not expected, users may have to tweak system parameters
+        actualWindow = _streamSock.getBuffSize(isRecv);
+        if (actualWindow < 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint get socket buffer size failed\n  %s", _streamSock.lastErrorMsg());
+            actualWindow = window;
+        }
+        else if (size_t(actualWindow) < window)
+        {
+            SoapySDR::logf(SOAPY_SDR_WARNING, "StreamEndpoint resize socket buffer: set %d KiB, got %d KiB", int(window/1024), int(actualWindow/1024));
+        }
+        if (socketPool != nullptr) socketPool->setSizedWindow(&_streamSock, isRecv, window, actualWindow);
     }
 
     //print summary
     SoapySDR::logf(SOAPY_SDR_INFO, "Configured %s endpoint: dgram=%d bytes, %d elements @ %d bytes, window=%d KiB",
         isRecv?"receiver":"sender", int(_xferSize), int(_buffSize*_numChans), int(_elemSize), int(actualWindow/1024));
 
+    //the wake socket is optional, without it the waits poll until timeout
+    const auto wakeURL = SoapyURL("udp", "127.0.0.1", "0").toString();
+    if (_wakeSock->bind(wakeURL) != 0 or _wakeSock->connect(_wakeSock->getsockname()) != 0)
+    {
+        SoapySDR::logf(SOAPY_SDR_DEBUG, "StreamEndpoint wake socket unavailable\n  %s", _wakeSock->lastErrorMsg());
+        delete _wakeSock;
+        _wakeSock = nullptr;
+    }
+
     //calculate flow control window
     if (isRecv)
     {
@@ -111,7 +147,43 @@ SoapyStreamEndpoint::SoapyStreamEndpoint(
 
 SoapyStreamEndpoint::~SoapyStreamEndpoint(void)
 {
-    return;
+    delete _wakeSock;
+}
+
+void SoapyStreamEndpoint::interrupt(void)
+{
+    //the datagram stays queued so every later wait returns immediately
+    if (_wakeSock != nullptr) _wakeSock->send("", 1);
+}
+
+void SoapyStreamEndpoint::setStripes(const std::vector<SoapyRPCSocket *> &socks)
+{
+    for (auto sock : socks)
+    {
+        //each connection gets the full window, the link delay is the same
+        if (sock->setBuffSize(_isRecv, _window) != 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint resize socket buffer to %d KiB failed\n  %s", int(_window/1024), sock->lastErrorMsg());
+        }
+        if (not _isRecv and sock->setNotSentLowat(SOAPY_REMOTE_TCP_NOTSENT_FRAMES*_mtu) != 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_WARNING, "StreamEndpoint set unsent limit failed\n  %s", sock->lastErrorMsg());
+        }
+        _stripeSocks.push_back(sock);
+    }
+    SoapySDR::logf(SOAPY_SDR_INFO, "Striped %s endpoint across %d connections",
+        _isRecv?"receiver":"sender", int(_stripeSocks.size()));
+}
+
+SoapyRPCSocket &SoapyStreamEndpoint::frameSock(const size_t sequence)
+{
+    return *_stripeSocks[uint32_t(sequence) % _stripeSocks.size()];
+}
+
+bool SoapyStreamEndpoint::waitReady(SoapyRPCSocket &sock, const long timeoutUs)
+{
+    if (_wakeSock == nullptr) return sock.selectRecv(timeoutUs);
+    return sock.selectRecv(timeoutUs, *_wakeSock);
 }
 
 void SoapyStreamEndpoint::sendACK(void)
@@ -166,7 +238,7 @@ bool SoapyStreamEndpoint::waitRecv(const long timeoutUs)
 {
     //send gratuitous ack until something is received
     if (not _receiveInitial) this->sendACK();
-    return _streamSock.selectRecv(timeoutUs);
+    return this->waitReady(this->frameSock(_lastRecvSequence), timeoutUs);
 }
 
 int SoapyStreamEndpoint::acquireRecv(size_t &handle, const void **buffs, int &flags, long long &timeNs)
@@ -184,13 +256,19 @@ int SoapyStreamEndpoint::acquireRecv(size_t &handle, const void **buffs, int &fl
     handle = _nextHandleAcquire;
     auto &data = _buffData[handle];
 
-    //receive into the buffer
+    //receive into the buffer, striped frames arrive in turn on each socket
     assert(not _streamSock.null());
-    if (_datagramMode) ret = _streamSock.recv(data.buff.data(), data.buff.size());
-    else ret = _streamSock.recv(data.buff.data(), HEADER_SIZE, MSG_WAITALL);
+    auto &sock = this->frameSock(_lastRecvSequence);
+    if (_datagramMode) ret = sock.recv(data.buff.data(), data.buff.size());
+    else ret = sock.recv(data.buff.data(), HEADER_SIZE, MSG_WAITALL);
     if (ret < 0)
     {
-        SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::acquireRecv(), FAILED %s", _streamSock.lastErrorMsg());
+        SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::acquireRecv(), FAILED %s", sock.lastErrorMsg());
+        return SOAPY_SDR_STREAM_ERROR;
+    }
+    if (size_t(ret) < HEADER_SIZE)
+    {
+        SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::acquireRecv(), FAILED %s", (ret == 0)?"connection closed":"short header");
         return SOAPY_SDR_STREAM_ERROR;
     }
     size_t bytesRecvd = size_t(ret);
@@ -207,12 +285,18 @@ int SoapyStreamEndpoint::acquireRecv(size_t &handle, const void **buffs, int &fl
         return SOAPY_SDR_STREAM_ERROR;
     }
 
+    //receive the rest of a tcp frame in one call
     else while (bytesRecvd < bytes)
     {
-        ret = _streamSock.recv(data.buff.data()+bytesRecvd, std::min<size_t>(SOAPY_REMOTE_SOCKET_BUFFMAX, bytes-bytesRecvd));
+        ret = sock.recv(data.buff.data()+bytesRecvd, bytes-bytesRecvd, MSG_WAITALL);
         if (ret < 0)
         {
-            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::acquireRecv(), FAILED %s", _streamSock.lastErrorMsg());
+            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::acquireRecv(), FAILED %s", sock.lastErrorMsg());
+            return SOAPY_SDR_STREAM_ERROR;
+        }
+        if (ret == 0)
+        {
+            SoapySDR::log(SOAPY_SDR_ERROR, "StreamEndpoint::acquireRecv(), FAILED connection closed");
             return SOAPY_SDR_STREAM_ERROR;
         }
         bytesRecvd += size_t(ret);
@@ -274,7 +358,7 @@ bool SoapyStreamEndpoint::waitSend(const long timeoutUs)
     while (not _receiveInitial or uint32_t(_lastSendSequence-_lastRecvSequence) >= _maxInFlightSeqs)
     {
         //wait for a flow control ACK to arrive
-        if (not _streamSock.selectRecv(timeoutUs)) return false;
+        if (not this->waitReady(_streamSock, timeoutUs)) return false;
 
         //exhaustive receive without timeout
         while (_streamSock.selectRecv(0)) this->recvACK();
@@ -319,21 +403,24 @@ void SoapyStreamEndpoint::releaseSend(const size_t handle, const int numElemsOrE
     //load the header
     auto header = (StreamDatagramHeader*)data.buff.data();
     size_t bytes = HEADER_SIZE + ((numElemsOrErr < 0)?0:(totalElems*_elemSize));
+    auto &sock = this->frameSock(_lastSendSequence);
     header->bytes = htonl(bytes);
     header->sequence = htonl(_lastSendSequence++);
     header->elems = htonl(numElemsOrErr);
     header->flags = htonl(flags);
     header->time = htonll(timeNs);
 
-    //send from the buffer
+    //send from the buffer, the header and payload are contiguous
+    //so a tcp frame is sent with one call unless interrupted
     assert(not _streamSock.null());
     size_t bytesSent = 0;
     while (bytesSent < bytes)
     {
-        int ret = _streamSock.send(data.buff.data()+bytesSent, std::min<size_t>(SOAPY_REMOTE_SOCKET_BUFFMAX, bytes-bytesSent));
+        const size_t toSend = _datagramMode?std::min<size_t>(SOAPY_REMOTE_SOCKET_BUFFMAX, bytes-bytesSent):(bytes-bytesSent);
+        int ret = sock.send(data.buff.data()+bytesSent, toSend);
         if (ret < 0)
         {
-            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::releaseSend(), FAILED %s", _streamSock.lastErrorMsg());
+            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::releaseSend(), FAILED %s", sock.lastErrorMsg());
             break;
         }
         bytesSent += size_t(ret);
@@ -358,7 +445,7 @@ void SoapyStreamEndpoint::releaseSend(const size_t handle, const int numElemsOrE
  **********************************************************************/
 bool SoapyStreamEndpoint::waitStatus(const long timeoutUs)
 {
-    return _statusSock.selectRecv(timeoutUs);
+    return this->waitReady(_statusSock, timeoutUs);
 }
 
 int SoapyStreamEndpoint::readStatus(size_t &chanMask, int &flags, long long &timeNs)
@@ -393,6 +480,21 @@ void SoapyStreamEndpoint::writeStatus(const int code, const size_t chanMask, con
     header.time = htonll(timeNs);
     header.elems = htonl(code);
 
+    //send on the shared status channel with the stream ID
+    if (_statusChannel != nullptr)
+    {
+        StatusChannelDatagram datagram;
+        datagram.header = header;
+        datagram.header.bytes = htonl(sizeof(datagram));
+        datagram.streamId = htonl(uint32_t(_statusStreamId));
+        int ret = _statusChannel->send(&datagram, sizeof(datagram));
+        if (ret < 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::writeStatus(), FAILED %s", _statusChannel->lastErrorMsg());
+        }
+        return;
+    }
+
     //send the status
     assert(not _statusSock.null());
     int ret = _statusSock.send(&header, sizeof(header));
@@ -405,3 +507,32 @@ void SoapyStreamEndpoint::writeStatus(const int code, const size_t chanMask, con
         SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::writeStatus(%d bytes), FAILED %d", int(sizeof(header)), ret);
     }
 }
+
+void SoapyStreamEndpoint::setStatusChannel(SoapyRPCSocket *sock, const int streamId)
+{
+    _statusChannel = sock;
+    _statusStreamId = streamId;
+}
+
+int SoapyStreamEndpoint::readStatusChannel(SoapyRPCSocket &sock, int &streamId, int &code, size_t &chanMask, int &flags, long long &timeNs)
+{
+    StatusChannelDatagram datagram;
+    int ret = sock.recv(&datagram, sizeof(datagram));
+    if (ret < 0) return SOAPY_SDR_STREAM_ERROR;
+
+    //check the header
+    size_t bytes = ntohl(datagram.header.bytes);
+    if (bytes != sizeof(datagram) or size_t(ret) != sizeof(datagram))
+    {
+        SoapySDR::logf(SOAPY_SDR_ERROR, "StreamEndpoint::readStatusChannel(%d bytes), FAILED %d", int(bytes), ret);
+        return SOAPY_SDR_STREAM_ERROR;
+    }
+
+    //set output parameters
+    streamId = int(ntohl(datagram.streamId));
+    code = int(ntohl(datagram.header.elems));
+    chanMask = ntohl(datagram.header.sequence);
+    flags = ntohl(datagram.header.flags);
+    timeNs = ntohll(datagram.header.time);
+    return 0;
+}
@@ -7,11 +7,13 @@
 #include <vector>
 
 class SoapyRPCSocket;
+class SoapySocketPool;
 
 /*!
  * The stream endpoint supports a windowed link datagram protocol.
  * This endpoint can be operated in only one mode: receive or send,
  * and must be paired with another differently configured endpoint.
+ * Sockets from a socket pool are only sized by the first endpoint.
  */
 class SOAPY_REMOTE_API SoapyStreamEndpoint
 {
@@ -24,7 +26,8 @@ public:
         const size_t numChans,
         const size_t elemSize,
         const size_t mtu,
-        const size_t window);
+        const size_t window,
+        SoapySocketPool *socketPool = nullptr);
 
     ~SoapyStreamEndpoint(void);
 
@@ -123,9 +126,51 @@ public:
      */
     void writeStatus(const int code, const size_t chanMask, const int flags, const long long timeNs);
 
+    /*!
+     * Send the status of this stream on a connection-wide status channel.
+     * Status messages carry the stream ID so the other end can demultiplex.
+     * The channel socket is shared by the endpoints of a connection.
+     */
+    void setStatusChannel(SoapyRPCSocket *sock, const int streamId);
+
+    /*!
+     * Stripe a tcp stream across additional connected sockets.
+     * The frame with sequence S travels on socket S mod N,
+     * where the stream socket is socket 0 and also carries the ACKs.
+     */
+    void setStripes(const std::vector<SoapyRPCSocket *> &socks);
+
+    /*!
+     * Read a status message from a connection-wide status channel.
+     * Return 0 or error code when the receive fails.
+     */
+    static int readStatusChannel(SoapyRPCSocket &sock, int &streamId, int &code, size_t &chanMask, int &flags, long long &timeNs);
+
+    /*!
+     * Wake up any waiting call from another thread.
+     * All waits return false (timeout) after the interrupt,
+     * so the forwarding threads can be stopped immediately.
+     */
+    void interrupt(void);
+
 private:
     SoapyRPCSocket &_streamSock;
     SoapyRPCSocket &_statusSock;
+
+    //loopback socket connected to itself to wake the waits
+    SoapyRPCSocket *_wakeSock;
+    bool waitReady(SoapyRPCSocket &sock, const long timeoutUs);
+
+    //stream sockets for striped tcp, the first is the stream socket
+    std::vector<SoapyRPCSocket *> _stripeSocks;
+    SoapyRPCSocket &frameSock(const size_t sequence);
+    bool _isRecv;
+    size_t _mtu, _window;
+
+    //optional shared status channel and this stream's ID on it
+    SoapyRPCSocket *_statusChannel;
+    int _statusStreamId;
+
     const bool _datagramMode;
     const size_t _xferSize;
     const size_t _numChans;
@@ -4,7 +4,12 @@
 
 #include "ClientHandler.hpp"
 #include "ServerStreamData.hpp"
+#include "ServerStatusChannel.hpp"
+#include "ServerSubscriptions.hpp"
+#include "ServerHeartbeat.hpp"
 #include "LogForwarding.hpp"
+#include "EnumerateCache.hpp"
+#include "DeviceFactory.hpp"
 #include "SoapyInfoUtils.hpp"
 #include "SoapyRemoteDefs.hpp"
 #include "SoapyURLUtils.hpp"
@@ -12,15 +17,15 @@
 #include "SoapyRPCPacker.hpp"
 #include "SoapyRPCUnpacker.hpp"
 #include "SoapyStreamEndpoint.hpp"
+#include "SoapySocketPool.hpp"
+#include "StreamHistory.hpp"
+#include "StreamRecorder.hpp"
 #include <SoapySDR/Device.hpp>
 #include <SoapySDR/Logger.hpp>
 #include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
 #include <iostream>
-#include <mutex>
-
-//! The device factory make and unmake requires a process-wide mutex
-static std::mutex factoryMutex;
+#include <algorithm> //find, min, max
 
 /***********************************************************************
  * Client handler constructor
@@ -30,6 +35,10 @@ SoapyClientHandler::SoapyClientHandler(SoapyRPCSocket &sock, const std::string &
     _uuid(uuid),
     _dev(nullptr),
     _logForwarder(nullptr),
+    _socketPool(new SoapySocketPool(SOAPY_REMOTE_SOCKET_POOL_SIZE)),
+    _statusChannel(nullptr),
+    _subscriptions(nullptr),
+    _heartbeat(nullptr),
     _nextStreamId(0)
 {
     return;
@@ -37,38 +46,320 @@ SoapyClientHandler::SoapyClientHandler(SoapyRPCSocket &sock, const std::string &
 
 SoapyClientHandler::~SoapyClientHandler(void)
 {
-    //stop all stream threads and close streams
+    //stop pushing and polling the stream status before closing streams
+    delete _heartbeat;
+    delete _subscriptions;
+    delete _statusChannel;
+
+    //stop all stream threads and close streams,
+    //signal every stream first so the threads exit together
+    for (auto &data : _streamData) data.second.signalStop();
     for (auto &data : _streamData)
     {
         data.second.stopThreads();
-        _dev->closeStream(data.second.stream);
+        if (data.second.stream != nullptr) _dev->closeStream(data.second.stream);
     }
 
     //release the device handle if we have it
     if (_dev != nullptr)
     {
-        std::lock_guard<std::mutex> lock(factoryMutex);
-        SoapySDR::Device::unmake(_dev);
+        ServerDeviceFactory::unmake(_dev);
         _dev = nullptr;
     }
 
+    //the stream data returns its sockets to the pool
+    _streamData.clear();
+    delete _socketPool;
+
     //finally stop and cleanup log forwarding
     delete _logForwarder;
 }
 
+/***********************************************************************
+ * Stream lookup by channel
+ **********************************************************************/
+ServerStreamData &SoapyClientHandler::getStreamData(const int direction, const size_t channel, size_t &index)
+{
+    for (auto &entry : _streamData)
+    {
+        auto &data = entry.second;
+        if (data.direction != direction or data.stream == nullptr) continue;
+        if (data.endpoint == nullptr and not data.recordOnly) continue;
+        const auto it = std::find(data.channels.begin(), data.channels.end(), channel);
+        if (it == data.channels.end()) continue;
+        index = size_t(it - data.channels.begin());
+        return data;
+    }
+    throw std::runtime_error("SoapyRemote -- no "+std::string((direction == SOAPY_SDR_RX)?"receive":"transmit")+
+        " stream for channel "+std::to_string(channel));
+}
+
+/***********************************************************************
+ * Stream history from the setup args
+ **********************************************************************/
+std::shared_ptr<SoapyStreamHistory> SoapyClientHandler::makeHistory(
+    const char direction,
+    const std::string &format,
+    const std::vector<size_t> &channels,
+    const SoapySDR::Kwargs &args)
+{
+    //a history time of 0 (the default) keeps no history
+    const auto historyIt = args.find(SOAPY_REMOTE_KWARG_HISTORY);
+    const double historyTime = (historyIt == args.end())?0.0:std::stod(historyIt->second);
+    if (historyTime < 0.0) throw std::runtime_error(
+        "SoapyRemote::setupStream() -- history time must not be negative: " + historyIt->second);
+    if (direction != SOAPY_SDR_RX or historyTime == 0.0) return std::shared_ptr<SoapyStreamHistory>();
+
+    const double rate = _dev->getSampleRate(direction, channels.empty()?0:channels.front());
+    const size_t numElems = size_t(historyTime*rate);
+    return std::make_shared<SoapyStreamHistory>(channels.size(), SoapySDR::formatToSize(format), numElems, rate);
+}
+
+/***********************************************************************
+ * Stream setup shared by the setup calls
+ **********************************************************************/
+int SoapyClientHandler::setupStream(
+    const char direction,
+    const std::string &format,
+    const std::vector<size_t> &channels,
+    const SoapySDR::Kwargs &args,
+    const std::string &clientBindPort,
+    const std::string &statusBindPort,
+    std::string &serverBindPort)
+{
+    //parse args for buffer configuration
+    size_t mtu = SOAPY_REMOTE_DEFAULT_ENDPOINT_MTU;
+    const auto mtuIt = args.find(SOAPY_REMOTE_KWARG_MTU);
+    if (mtuIt != args.end()) mtu = size_t(std::stod(mtuIt->second));
+
+    size_t window = SOAPY_REMOTE_DEFAULT_ENDPOINT_WINDOW;
+    const auto windowIt = args.find(SOAPY_REMOTE_KWARG_WINDOW);
+    if (windowIt != args.end()) window = size_t(std::stod(windowIt->second));
+
+    double priority = SOAPY_REMOTE_DEFAULT_THREAD_PRIORITY;
+    const auto priorityIt = args.find(SOAPY_REMOTE_KWARG_PRIORITY);
+    if (priorityIt != args.end()) priority = std::stod(priorityIt->second);
+
+    //parse args for the transmit jitter buffer
+    size_t jitterElems = 0;
+    double jitterRate = 0.0;
+    const auto prefillIt = args.find(SOAPY_REMOTE_KWARG_PREFILL);
+    const auto latencyIt = args.find(SOAPY_REMOTE_KWARG_LATENCY);
+    if (direction == SOAPY_SDR_TX and (prefillIt != args.end() or latencyIt != args.end()))
+    {
+        jitterRate = _dev->getSampleRate(direction, channels.empty()?0:channels.front());
+        if (prefillIt != args.end()) jitterElems = size_t(std::stod(prefillIt->second));
+        if (latencyIt != args.end()) jitterElems = std::max(jitterElems, size_t(std::stod(latencyIt->second)*jitterRate/1e6));
+        if (jitterRate <= 0.0) jitterElems = 0; //cannot convert to a fill timeout
+    }
+
+    std::string prot = "udp";
+    const auto protIt = args.find(SOAPY_REMOTE_KWARG_PROT);
+    if (protIt != args.end()) prot = protIt->second;
+    const bool datagramMode = (prot == "udp");
+    const bool useStatusChannel = datagramMode and statusBindPort.empty();
+
+    size_t numStripes = 1;
+    const auto stripesIt = args.find(SOAPY_REMOTE_KWARG_STRIPES);
+    if (not datagramMode and stripesIt != args.end()) numStripes = std::stoul(stripesIt->second);
+    if (numStripes < 1 or numStripes > SOAPY_REMOTE_MAX_STRIPES) throw std::runtime_error(
+        "SoapyRemote::setupStream() -- stripes out of range: " + std::to_string(numStripes));
+    if (useStatusChannel and _statusChannel == nullptr) throw std::runtime_error(
+        "SoapyRemote::setupStream() -- no status port and no status channel");
+
+    size_t chanMask = 0;
+    for (const auto chan : channels) chanMask |= (1 << chan);
+
+    //replay streams read from the history of another receive stream
+    const auto replayIt = args.find(SOAPY_REMOTE_KWARG_REPLAY);
+    const bool replay = (replayIt != args.end() and replayIt->second == "true");
+    std::shared_ptr<SoapyStreamHistory> history;
+    if (replay)
+    {
+        if (direction != SOAPY_SDR_RX) throw std::runtime_error(
+            "SoapyRemote::setupStream() -- replay requires a receive stream");
+        for (const auto &entry : _streamData)
+        {
+            if (entry.second.replay or not entry.second.history) continue;
+            if (entry.second.chanMask != chanMask or entry.second.format != format) continue;
+            history = entry.second.history;
+        }
+        if (not history) throw std::runtime_error(
+            "SoapyRemote::setupStream() -- no stream history for the requested channels and format");
+    }
+
+    //allocate the history before the stream so failures do not leak the stream
+    if (not replay) history = this->makeHistory(direction, format, channels, args);
+
+    //create stream
+    SoapySDR::Stream *stream = nullptr;
+    if (not replay) stream = _dev->setupStream(direction, format, channels, args);
+
+    //load data structure
+    auto &data = _streamData[_nextStreamId];
+    data.streamId = _nextStreamId++;
+    data.device = _dev;
+    data.stream = stream;
+    data.direction = direction;
+    data.format = format;
+    data.channels = channels;
+    data.chanMask = chanMask;
+    data.priority = priority;
+    data.jitterElems = jitterElems;
+    data.jitterRate = jitterRate;
+    data.history = history;
+    data.replay = replay;
+    data.useStatusChannel = useStatusChannel;
+
+    //extract socket node information
+    const auto localNode = SoapyURL(_sock.getsockname()).getNode();
+    const auto remoteNode = SoapyURL(_sock.getpeername()).getNode();
+
+    const auto bindURL = SoapyURL(prot, localNode, "0").toString();
+
+    //in udp mode connect to the bound sockets on the client side
+    if (datagramMode)
+    {
+        //streams on the status channel leave their status socket unused
+        if (useStatusChannel)
+        {
+            _socketPool->acquire(data.streamSock);
+            data.statusSock = new SoapyRPCSocket();
+        }
+        else _socketPool->acquire(data.streamSock, data.statusSock);
+
+        //bind the stream socket to an automatic port (unless reused)
+        int ret = data.streamSock->null()?data.streamSock->bind(bindURL):0;
+        if (ret != 0)
+        {
+            const std::string errorMsg = data.streamSock->lastErrorMsg();
+            _streamData.erase(data.streamId);
+            throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- bind FAIL: " + errorMsg);
+        }
+        SoapySDR::logf(SOAPY_SDR_INFO, "Server side stream bound to %s", data.streamSock->getsockname().c_str());
+        serverBindPort = SoapyURL(data.streamSock->getsockname()).getService();
+
+        //connect the stream socket to the specified port
+        auto connectURL = SoapyURL("udp", remoteNode, clientBindPort).toString();
+        ret = data.streamSock->connect(connectURL);
+        if (ret != 0)
+        {
+            const std::string errorMsg = data.streamSock->lastErrorMsg();
+            _streamData.erase(data.streamId);
+            throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
+        }
+        SoapySDR::logf(SOAPY_SDR_INFO, "Server side stream connected to %s", data.streamSock->getpeername().c_str());
+
+        //connect the status socket to the specified port,
+        //no port means the status goes over the status channel
+        if (not useStatusChannel)
+        {
+            connectURL = SoapyURL("udp", remoteNode, statusBindPort).toString();
+            ret = data.statusSock->connect(connectURL);
+            if (ret != 0)
+            {
+                const std::string errorMsg = data.statusSock->lastErrorMsg();
+                _streamData.erase(data.streamId);
+                throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
+            }
+            SoapySDR::logf(SOAPY_SDR_INFO, "Server side status connected to %s", data.statusSock->getpeername().c_str());
+        }
+    }
+
+    //in tcp mode, setup the server socket to listen,
+    //send the binding port back to the client and
+    //accept the client's new connections
+    else
+    {
+        SoapyRPCSocket serverSocket;
+        int ret = serverSocket.bind(bindURL);
+        if (ret != 0)
+        {
+            const std::string errorMsg = serverSocket.lastErrorMsg();
+            _streamData.erase(data.streamId);
+            throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- bind FAIL: " + errorMsg);
+        }
+        SoapySDR::logf(SOAPY_SDR_INFO, "Server side stream bound to %s", serverSocket.getsockname().c_str());
+        serverBindPort = SoapyURL(serverSocket.getsockname()).getService();
+
+        serverSocket.listen(int(numStripes)+1);
+        {
+            std::lock_guard<std::mutex> lock(_sendMutex);
+            SoapyRPCPacker packerTcp(_sock);
+            packerTcp & serverBindPort;
+            packerTcp();
+        }
+        data.streamSock = serverSocket.accept();
+        data.statusSock = serverSocket.accept();
+        for (size_t i = 1; i < numStripes and data.statusSock != nullptr; i++)
+        {
+            auto sock = serverSocket.accept();
+            if (sock == nullptr) break;
+            data.stripeSocks.push_back(sock);
+        }
+        if (data.streamSock == nullptr or data.statusSock == nullptr or data.stripeSocks.size()+1 != numStripes)
+        {
+            const std::string errorMsg = serverSocket.lastErrorMsg();
+            throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- accept FAIL: " + errorMsg);
+        }
+    }
+
+    //create endpoint
+    //the datagram sockets go back to the pool when the stream closes
+    if (datagramMode) data.socketPool = _socketPool;
+    data.endpoint = new SoapyStreamEndpoint(*data.streamSock, *data.statusSock,
+        datagramMode, direction == SOAPY_SDR_TX, channels.size(),
+        SoapySDR::formatToSize(format), mtu, window, data.socketPool);
+
+    if (not data.stripeSocks.empty()) data.endpoint->setStripes(data.stripeSocks);
+
+    //status is tagged with the stream ID on the shared channel
+    if (useStatusChannel) data.endpoint->setStatusChannel(&_statusChannel->socket(), data.streamId);
+
+    //start worker thread, this is not backwards,
+    //receive from device means using a send endpoint
+    //transmit to device means using a recv endpoint
+    if (replay) data.startReplayThread();
+    else
+    {
+        if (direction == SOAPY_SDR_RX) data.startSendThread();
+        if (direction == SOAPY_SDR_TX) data.startRecvThread();
+        if (useStatusChannel) _statusChannel->add(&data);
+        else data.startStatThread();
+    }
+
+    return data.streamId;
+}
+
 /***********************************************************************
  * Transaction handler
  **********************************************************************/
 bool SoapyClientHandler::handleOnce(void)
 {
-    if (not _sock.selectRecv(SOAPY_REMOTE_SOCKET_TIMEOUT_US)) return true;
+    //subscriptions are pushed between requests,
+    //so the device is never called from another thread
+    long timeoutUs = SOAPY_REMOTE_SOCKET_TIMEOUT_US;
+    if (_subscriptions != nullptr)
+    {
+        _subscriptions->pushDue();
+        const long waitUs = _subscriptions->waitUs();
+        if (waitUs >= 0) timeoutUs = std::min(timeoutUs, waitUs);
+    }
+    if (not _sock.selectRecv(timeoutUs)) return true;
 
     //receive the client's request
     SoapyRPCUnpacker unpacker(_sock, true, -1/*no timeout*/);
     SoapyRPCPacker packer(_sock, unpacker.remoteRPCVersion());
 
+    //heartbeats tell the client that a long call is still running
+    if (_heartbeat == nullptr and unpacker.remoteRPCVersion() >= SoapyRPCVersionHeartbeat)
+    {
+        _heartbeat = new ServerHeartbeat(_sock, _sendMutex, unpacker.remoteRPCVersion());
+    }
+
     //handle the client's request
     bool again = true;
+    if (_heartbeat != nullptr) _heartbeat->begin();
     try
     {
         again = this->handleOnce(unpacker, packer);
@@ -77,9 +368,22 @@ bool SoapyClientHandler::handleOnce(void)
     {
         packer & ex;
     }
+    if (_heartbeat != nullptr) _heartbeat->end();
 
-    //send the result back
-    packer();
+    //send the result back, log messages on this socket wait for the reply
+    auto logForwarder = _logForwarder;
+    if (logForwarder != nullptr) logForwarder->beginReply();
+    try
+    {
+        std::lock_guard<std::mutex> lock(_sendMutex);
+        packer();
+    }
+    catch (...)
+    {
+        if (logForwarder != nullptr) logForwarder->endReply();
+        throw;
+    }
+    if (logForwarder != nullptr) logForwarder->endReply();
 
     return again;
 }
@@ -101,7 +405,7 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
     {
         SoapySDR::Kwargs args;
         unpacker & args;
-        packer & SoapySDR::Device::enumerate(args);
+        packer & ServerEnumerateCache::enumerate(args);
     } break;
 
     ////////////////////////////////////////////////////////////////////
@@ -110,8 +414,7 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
     {
         SoapySDR::Kwargs args;
         unpacker & args;
-        std::lock_guard<std::mutex> lock(factoryMutex);
-        if (_dev == nullptr) _dev = SoapySDR::Device::make(args);
+        if (_dev == nullptr) _dev = ServerDeviceFactory::make(args);
         packer & SOAPY_REMOTE_VOID;
     } break;
 
@@ -124,16 +427,35 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         {
             SoapySDR::log(SOAPY_SDR_WARNING, "Performing automatic closeStream() before Device unmake.");
         }
+        if (_statusChannel != nullptr) for (auto &data : _streamData) _statusChannel->remove(data.first);
+        for (auto &data : _streamData) data.second.signalStop();
         for (auto &data : _streamData)
         {
             data.second.stopThreads();
-            _dev->closeStream(data.second.stream);
+            if (data.second.stream != nullptr) _dev->closeStream(data.second.stream);
         }
         _streamData.clear();
-
-        std::lock_guard<std::mutex> lock(factoryMutex);
-        if (_dev != nullptr) SoapySDR::Device::unmake(_dev);
+        for (const auto &recorder : _recorders) recorder.second->stop();
+
+        //the connection may be reused for another device,
+        //which starts without the recordings and cached waveforms
+        _recorders.clear();
+        _waveforms.clear();
+        delete _subscriptions;
+        _subscriptions = nullptr;
+        delete _statusChannel;
+        _statusChannel = nullptr;
+
+        if (_dev != nullptr) ServerDeviceFactory::unmake(_dev);
         _dev = nullptr;
+
+        //pushed log messages end with the device,
+        //the remaining messages are sent before the reply
+        if (unpacker.remoteRPCVersion() >= SoapyRPCVersionLogPush)
+        {
+            delete _logForwarder;
+            _logForwarder = nullptr;
+        }
         packer & SOAPY_REMOTE_VOID;
     } break;
 
@@ -155,7 +477,12 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
     case SOAPY_REMOTE_START_LOG_FORWARDING:
     ////////////////////////////////////////////////////////////////////
     {
-        if (_logForwarder == nullptr) _logForwarder = new SoapyLogForwarder(_sock);
+        //newer clients send the forwarding options,
+        //and take the log messages as pushes on the control socket
+        SoapySDR::Kwargs args;
+        if (not unpacker.done()) unpacker & args;
+        const bool push = unpacker.remoteRPCVersion() >= SoapyRPCVersionLogPush;
+        if (_logForwarder == nullptr) _logForwarder = new SoapyLogForwarder(_sock, args, push?&_sendMutex:nullptr);
         packer & SOAPY_REMOTE_VOID;
     } break;
 
@@ -302,126 +629,76 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         unpacker & clientBindPort;
         unpacker & statusBindPort;
 
-        //parse args for buffer configuration
-        size_t mtu = SOAPY_REMOTE_DEFAULT_ENDPOINT_MTU;
-        const auto mtuIt = args.find(SOAPY_REMOTE_KWARG_MTU);
-        if (mtuIt != args.end()) mtu = size_t(std::stod(mtuIt->second));
-
-        size_t window = SOAPY_REMOTE_DEFAULT_ENDPOINT_WINDOW;
-        const auto windowIt = args.find(SOAPY_REMOTE_KWARG_WINDOW);
-        if (windowIt != args.end()) window = size_t(std::stod(windowIt->second));
-
-        double priority = SOAPY_REMOTE_DEFAULT_THREAD_PRIORITY;
-        const auto priorityIt = args.find(SOAPY_REMOTE_KWARG_PRIORITY);
-        if (priorityIt != args.end()) priority = std::stod(priorityIt->second);
-
-        std::string prot = "udp";
-        const auto protIt = args.find(SOAPY_REMOTE_KWARG_PROT);
-        if (protIt != args.end()) prot = protIt->second;
-        const bool datagramMode = (prot == "udp");
-
-        //create stream
-        auto stream = _dev->setupStream(direction, format, channels, args);
-
-        //load data structure
-        auto &data = _streamData[_nextStreamId];
-        data.streamId = _nextStreamId++;
-        data.device = _dev;
-        data.stream = stream;
-        data.format = format;
-        for (const auto chan : channels) data.chanMask |= (1 << chan);
-        data.priority = priority;
-
-        //extract socket node information
-        const auto localNode = SoapyURL(_sock.getsockname()).getNode();
-        const auto remoteNode = SoapyURL(_sock.getpeername()).getNode();
-
-        const auto bindURL = SoapyURL(prot, localNode, "0").toString();
         std::string serverBindPort;
+        packer & this->setupStream(direction, format, channels, args, clientBindPort, statusBindPort, serverBindPort);
+        packer & serverBindPort;
+    } break;
 
-        //in udp mode connect to the bound sockets on the client side
-        if (datagramMode)
-        {
-            data.streamSock = new SoapyRPCSocket();
-            data.statusSock = new SoapyRPCSocket();
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_SETUP_STREAM_NEGOTIATE:
+    ////////////////////////////////////////////////////////////////////
+    {
+        char direction = 0;
+        std::string localFormat;
+        std::vector<std::string> convertible;
+        std::vector<size_t> channels;
+        SoapySDR::Kwargs args;
+        std::string clientBindPort;
+        std::string statusBindPort;
+        unpacker & direction;
+        unpacker & localFormat;
+        unpacker & convertible;
+        unpacker & channels;
+        unpacker & args;
+        unpacker & clientBindPort;
+        unpacker & statusBindPort;
 
-            //bind the stream socket to an automatic port
-            int ret = data.streamSock->bind(bindURL);
-            if (ret != 0)
-            {
-                const std::string errorMsg = data.streamSock->lastErrorMsg();
-                _streamData.erase(data.streamId);
-                throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- bind FAIL: " + errorMsg);
-            }
-            SoapySDR::logf(SOAPY_SDR_INFO, "Server side stream bound to %s", data.streamSock->getsockname().c_str());
-            serverBindPort = SoapyURL(data.streamSock->getsockname()).getService();
+        //prefer the native format when the client can convert it,
+        //otherwise the client's local format or the requested format
+        double fullScale = 0.0;
+        const auto nativeFormat = _dev->getNativeStreamFormat(direction, channels.empty()?0:channels.front(), fullScale);
+        const bool useNative = std::find(convertible.begin(), convertible.end(), nativeFormat) != convertible.end();
+        std::string format = useNative?nativeFormat:localFormat;
+        const auto formatIt = args.find(SOAPY_REMOTE_KWARG_FORMAT);
+        if (formatIt != args.end()) format = formatIt->second;
 
-            //connect the stream socket to the specified port
-            auto connectURL = SoapyURL("udp", remoteNode, clientBindPort).toString();
-            ret = data.streamSock->connect(connectURL);
-            if (ret != 0)
-            {
-                const std::string errorMsg = data.streamSock->lastErrorMsg();
-                _streamData.erase(data.streamId);
-                throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
-            }
-            SoapySDR::logf(SOAPY_SDR_INFO, "Server side stream connected to %s", data.streamSock->getpeername().c_str());
+        double scaleFactor = (format == nativeFormat)?fullScale:double(1 << ((SoapySDR::formatToSize(format)*4)-1));
+        const auto scaleIt = args.find(SOAPY_REMOTE_KWARG_SCALE);
+        if (scaleIt != args.end()) scaleFactor = std::stod(scaleIt->second);
 
-            //connect the status socket to the specified port
-            connectURL = SoapyURL("udp", remoteNode, statusBindPort).toString();
-            ret = data.statusSock->connect(connectURL);
-            if (ret != 0)
-            {
-                const std::string errorMsg = data.statusSock->lastErrorMsg();
-                _streamData.erase(data.streamId);
-                throw std::runtime_error("SoapyRemote::setupStream("+connectURL+") -- connect FAIL: " + errorMsg);
-            }
-            SoapySDR::logf(SOAPY_SDR_INFO, "Server side status connected to %s", data.statusSock->getpeername().c_str());
-        }
+        std::string serverBindPort;
+        const int streamId = this->setupStream(direction, format, channels, args, clientBindPort, statusBindPort, serverBindPort);
 
-        //in tcp mode, setup the server socket to listen,
-        //send the binding port back to the client and
-        //accept the client's new connections
-        else
+        //optionally activate in the same exchange
+        int activateResult = 0;
+        const auto activateIt = args.find(SOAPY_REMOTE_KWARG_ACTIVATE);
+        if (activateIt != args.end() and activateIt->second == "true")
         {
-            SoapyRPCSocket serverSocket;
-            int ret = serverSocket.bind(bindURL);
-            if (ret != 0)
-            {
-                const std::string errorMsg = serverSocket.lastErrorMsg();
-                _streamData.erase(data.streamId);
-                throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- bind FAIL: " + errorMsg);
-            }
-            SoapySDR::logf(SOAPY_SDR_INFO, "Server side stream bound to %s", serverSocket.getsockname().c_str());
-            serverBindPort = SoapyURL(serverSocket.getsockname()).getService();
-
-            serverSocket.listen(2);
-            SoapyRPCPacker packerTcp(_sock);
-            packerTcp & serverBindPort;
-            packerTcp();
-            data.streamSock = serverSocket.accept();
-            data.statusSock = serverSocket.accept();
-            if (data.streamSock == nullptr or data.statusSock == nullptr)
-            {
-                const std::string errorMsg = serverSocket.lastErrorMsg();
-                throw std::runtime_error("SoapyRemote::setupStream("+bindURL+") -- accept FAIL: " + errorMsg);
-            }
+            auto &data = _streamData.at(streamId);
+            if (data.replay) activateResult = data.requestReplay(0, 0, 0);
+            else activateResult = _dev->activateStream(data.stream);
         }
 
-        //create endpoint
-        data.endpoint = new SoapyStreamEndpoint(*data.streamSock, *data.statusSock,
-            datagramMode, direction == SOAPY_SDR_TX, channels.size(),
-            SoapySDR::formatToSize(format), mtu, window);
+        packer & streamId;
+        packer & serverBindPort;
+        packer & format;
+        packer & scaleFactor;
+        packer & activateResult;
+    } break;
 
-        //start worker thread, this is not backwards,
-        //receive from device means using a send endpoint
-        //transmit to device means using a recv endpoint
-        if (direction == SOAPY_SDR_RX) data.startSendThread();
-        if (direction == SOAPY_SDR_TX) data.startRecvThread();
-        data.startStatThread();
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_SETUP_STATUS_CHANNEL:
+    ////////////////////////////////////////////////////////////////////
+    {
+        std::string statusBindPort;
+        unpacker & statusBindPort;
 
-        packer & data.streamId;
-        packer & serverBindPort;
+        //one channel per connection, streams already on it keep the old one
+        if (_statusChannel != nullptr) throw std::runtime_error(
+            "SoapyRemote::setupStatusChannel() -- status channel already setup");
+        const auto remoteNode = SoapyURL(_sock.getpeername()).getNode();
+        _statusChannel = new ServerStatusChannel(SoapyURL("udp", remoteNode, statusBindPort).toString());
+        packer & SOAPY_REMOTE_VOID;
     } break;
 
     ////////////////////////////////////////////////////////////////////
@@ -433,8 +710,13 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
 
         //cleanup data and stop worker thread
         auto &data = _streamData.at(streamId);
+        if (_statusChannel != nullptr) _statusChannel->remove(streamId);
         data.stopThreads();
-        _dev->closeStream(data.stream);
+        for (const auto &recorder : _recorders)
+        {
+            if (data.removeRecorder(recorder.second)) recorder.second->stop();
+        }
+        if (data.stream != nullptr) _dev->closeStream(data.stream);
         _streamData.erase(streamId);
 
         packer & SOAPY_REMOTE_VOID;
@@ -454,7 +736,8 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         unpacker & numElems;
 
         auto &data = _streamData.at(streamId);
-        packer & _dev->activateStream(data.stream, flags, timeNs, size_t(numElems));
+        if (data.replay) packer & data.requestReplay(flags, timeNs, size_t(numElems));
+        else packer & _dev->activateStream(data.stream, flags, timeNs, size_t(numElems));
     } break;
 
     ////////////////////////////////////////////////////////////////////
@@ -469,7 +752,163 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         unpacker & timeNs;
 
         auto &data = _streamData.at(streamId);
-        packer & _dev->deactivateStream(data.stream, flags, timeNs);
+        if (data.replay) packer & data.cancelReplay();
+        else packer & _dev->deactivateStream(data.stream, flags, timeNs);
+    } break;
+
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_REPLAY_STREAM_HISTORY:
+    ////////////////////////////////////////////////////////////////////
+    {
+        int streamId = 0;
+        int flags = 0;
+        long long timeNs = 0;
+        int numElems = 0;
+        unpacker & streamId;
+        unpacker & flags;
+        unpacker & timeNs;
+        unpacker & numElems;
+
+        auto &data = _streamData.at(streamId);
+        if (not data.replay) throw std::runtime_error(
+            "SoapyRemote::replayStreamHistory() -- stream was not setup with remote:replay");
+        packer & data.requestReplay(flags, timeNs, size_t(numElems));
+    } break;
+
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_START_RECORDING:
+    ////////////////////////////////////////////////////////////////////
+    {
+        char direction = 0;
+        int channel = 0;
+        std::string path;
+        unpacker & direction;
+        unpacker & channel;
+        unpacker & path;
+
+        if (direction != SOAPY_SDR_RX) throw std::runtime_error(
+            "SoapyRemote::startRecording() -- recording requires a receive channel");
+        size_t index = 0;
+        auto &streamData = this->getStreamData(direction, channel, index);
+
+        //replace the previous recording on this channel
+        auto &recorder = _recorders[channel];
+        if (recorder)
+        {
+            for (auto &entry : _streamData) entry.second.removeRecorder(recorder);
+            recorder.reset();
+        }
+
+        recorder = std::make_shared<SoapyStreamRecorder>(path, streamData.format,
+            _dev->getSampleRate(direction, channel), _dev->getFrequency(direction, channel),
+            _dev->getHardwareKey());
+        streamData.addRecorder(index, recorder);
+        packer & SOAPY_REMOTE_VOID;
+    } break;
+
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_STOP_RECORDING:
+    ////////////////////////////////////////////////////////////////////
+    {
+        char direction = 0;
+        int channel = 0;
+        unpacker & direction;
+        unpacker & channel;
+
+        //keep the stopped recorder around for the final statistics
+        const auto it = _recorders.find(channel);
+        if (it != _recorders.end())
+        {
+            for (auto &entry : _streamData) entry.second.removeRecorder(it->second);
+            it->second->stop();
+        }
+        packer & SOAPY_REMOTE_VOID;
+    } break;
+
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_GET_RECORDING_STATUS:
+    ////////////////////////////////////////////////////////////////////
+    {
+        char direction = 0;
+        int channel = 0;
+        unpacker & direction;
+        unpacker & channel;
+
+        SoapySDR::Kwargs result;
+        const auto it = _recorders.find(channel);
+        if (it != _recorders.end()) result = it->second->status();
+        packer & result;
+    } break;
+
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_UPLOAD_WAVEFORM:
+    ////////////////////////////////////////////////////////////////////
+    {
+        std::string name;
+        std::string format;
+        int numChans = 0;
+        int numElems = 0;
+        std::string samples;
+        unpacker & name;
+        unpacker & format;
+        unpacker & numChans;
+        unpacker & numElems;
+        unpacker & samples;
+
+        //an empty upload removes the waveform from the cache
+        if (numElems == 0) _waveforms.erase(name);
+        else
+        {
+            const size_t expected = size_t(numChans)*size_t(numElems)*SoapySDR::formatToSize(format);
+            if (numChans <= 0 or samples.size() != expected) throw std::runtime_error(
+                "SoapyRemote::uploadWaveform("+name+") -- expected "+std::to_string(expected)+" bytes");
+            auto waveform = std::make_shared<ServerWaveform>();
+            waveform->format = format;
+            waveform->numChans = size_t(numChans);
+            waveform->numElems = size_t(numElems);
+            waveform->samples.swap(samples);
+            _waveforms[name] = waveform;
+            SoapySDR::logf(SOAPY_SDR_INFO, "Cached waveform %s (%s, %d channels, %d elements)",
+                name.c_str(), format.c_str(), numChans, numElems);
+        }
+        packer & SOAPY_REMOTE_VOID;
+    } break;
+
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_PLAY_WAVEFORM:
+    ////////////////////////////////////////////////////////////////////
+    {
+        char direction = 0;
+        int channel = 0;
+        std::string name;
+        int repeat = 0;
+        int flags = 0;
+        long long timeNs = 0;
+        unpacker & direction;
+        unpacker & channel;
+        unpacker & name;
+        unpacker & repeat;
+        unpacker & flags;
+        unpacker & timeNs;
+
+        if (direction != SOAPY_SDR_TX) throw std::runtime_error(
+            "SoapyRemote::playWaveform() -- playback requires a transmit channel");
+        size_t index = 0;
+        auto &data = this->getStreamData(direction, channel, index);
+
+        //an empty name stops the playback
+        if (name.empty()) data.stopPlayback();
+        else
+        {
+            const auto it = _waveforms.find(name);
+            if (it == _waveforms.end()) throw std::runtime_error(
+                "SoapyRemote::playWaveform("+name+") -- no such waveform");
+            const auto &waveform = it->second;
+            if (waveform->format != data.format or waveform->numChans != data.channels.size()) throw std::runtime_error(
+                "SoapyRemote::playWaveform("+name+") -- waveform does not match the stream format and channels");
+            data.requestPlayback(waveform, size_t(std::max(repeat, 0)), flags, timeNs);
+        }
+        packer & SOAPY_REMOTE_VOID;
     } break;
 
     ////////////////////////////////////////////////////////////////////
@@ -485,6 +924,14 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         unpacker & channels;
         unpacker & args;
 
+        //record-only receive streams read the device on a server thread
+        //for the recordings and history, nothing is streamed to the client
+        const auto recordOnlyIt = args.find(SOAPY_REMOTE_KWARG_RECORD_ONLY);
+        const bool recordOnly = (direction == SOAPY_SDR_RX and recordOnlyIt != args.end() and recordOnlyIt->second == "true");
+        const auto readerChannels = channels.empty()?std::vector<size_t>(1, 0):channels;
+        std::shared_ptr<SoapyStreamHistory> history;
+        if (recordOnly) history = this->makeHistory(direction, format, readerChannels, args);
+
         //create stream
         auto stream = _dev->setupStream(direction, format, channels, args);
 
@@ -495,6 +942,19 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         data.stream = stream;
         data.format = format;
 
+        if (recordOnly)
+        {
+            data.recordOnly = true;
+            data.history = history;
+            data.direction = direction;
+            data.channels = readerChannels;
+            for (const auto chan : data.channels) data.chanMask |= (1 << chan);
+            data.priority = SOAPY_REMOTE_DEFAULT_THREAD_PRIORITY;
+            const auto priorityIt = args.find(SOAPY_REMOTE_KWARG_PRIORITY);
+            if (priorityIt != args.end()) data.priority = std::stod(priorityIt->second);
+            data.startReaderThread();
+        }
+
         packer & data.streamId;
     } break;
 
@@ -1200,6 +1660,23 @@ bool SoapyClientHandler::handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &
         packer & _dev->readSensor(direction, channel, name);
     } break;
 
+    ////////////////////////////////////////////////////////////////////
+    case SOAPY_REMOTE_SUBSCRIBE:
+    ////////////////////////////////////////////////////////////////////
+    {
+        std::string what;
+        char direction = 0;
+        int channel = 0;
+        double period = 0.0;
+        unpacker & what;
+        unpacker & direction;
+        unpacker & channel;
+        unpacker & period;
+        if (_subscriptions == nullptr) _subscriptions = new ServerSubscriptions(_sock, _sendMutex, _dev, unpacker.remoteRPCVersion());
+        _subscriptions->subscribe(what, direction, channel, (long long)(period*1e6));
+        packer & SOAPY_REMOTE_VOID;
+    } break;
+
     ////////////////////////////////////////////////////////////////////
     case SOAPY_REMOTE_WRITE_REGISTER:
     ////////////////////////////////////////////////////////////////////
@@ -2,15 +2,26 @@
 // SPDX-License-Identifier: BSL-1.0
 
 #pragma once
+#include <SoapySDR/Types.hpp>
 #include <cstddef>
 #include <string>
+#include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 
 class SoapyRPCSocket;
 class SoapyRPCPacker;
 class SoapyRPCUnpacker;
 class SoapyLogForwarder;
 class ServerStreamData;
+class SoapyStreamRecorder;
+class SoapyStreamHistory;
+class SoapySocketPool;
+class ServerStatusChannel;
+class ServerSubscriptions;
+class ServerHeartbeat;
+struct ServerWaveform;
 
 namespace SoapySDR
 {
@@ -33,12 +44,52 @@ public:
 private:
     bool handleOnce(SoapyRPCUnpacker &unpacker, SoapyRPCPacker &packer);
 
+    //find the active device stream that carries a channel
+    ServerStreamData &getStreamData(const int direction, const size_t channel, size_t &index);
+
+    //allocate the history of a receive stream from the args (null without history)
+    std::shared_ptr<SoapyStreamHistory> makeHistory(
+        const char direction,
+        const std::string &format,
+        const std::vector<size_t> &channels,
+        const SoapySDR::Kwargs &args);
+
+    //create the device stream and its endpoint, return the stream id
+    int setupStream(
+        const char direction,
+        const std::string &format,
+        const std::vector<size_t> &channels,
+        const SoapySDR::Kwargs &args,
+        const std::string &clientBindPort,
+        const std::string &statusBindPort,
+        std::string &serverBindPort);
+
     SoapyRPCSocket &_sock;
     const std::string _uuid;
     SoapySDR::Device *_dev;
     SoapyLogForwarder *_logForwarder;
 
+    //reusable datagram sockets for stream endpoints
+    SoapySocketPool *_socketPool;
+
+    //shared status channel for datagram streams (when setup by the client)
+    ServerStatusChannel *_statusChannel;
+
+    //pushed sensor updates (when subscribed by the client),
+    //the send mutex keeps pushes and replies whole on the socket
+    ServerSubscriptions *_subscriptions;
+    std::mutex _sendMutex;
+
+    //pushed heartbeats during calls (when the client supports them)
+    ServerHeartbeat *_heartbeat;
+
     //stream tracking
     int _nextStreamId;
     std::map<int, ServerStreamData> _streamData;
+
+    //last recording by receive channel
+    std::map<size_t, std::shared_ptr<SoapyStreamRecorder>> _recorders;
+
+    //cached waveforms by name
+    std::map<std::string, std::shared_ptr<const ServerWaveform>> _waveforms;
 };
@@ -0,0 +1,291 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "DeviceFactory.hpp"
+#include "EnumerateCache.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <condition_variable>
+#include <algorithm> //find, find_if
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <map>
+
+/***********************************************************************
+ * factory locks: per-device locks are held under a shared global lock,
+ * non-reentrant drivers hold the global lock exclusively
+ **********************************************************************/
+struct DeviceIdentity
+{
+    DeviceIdentity(void):
+        refs(0)
+    {
+        return;
+    }
+    std::string driver;
+    std::string key;
+    std::string args; //the make args (for logging and the warm pool)
+    size_t refs; //the factory returns the same device for the same args
+};
+
+struct DeviceLock
+{
+    DeviceLock(void):
+        users(0)
+    {
+        return;
+    }
+    std::mutex mutex;
+    size_t users; //callers holding or waiting on the mutex
+};
+
+static std::mutex factoryMutex;
+static std::condition_variable factoryCond;
+static size_t factoryShared = 0;
+static bool factoryExclusive = false;
+static std::vector<std::string> globalLockDrivers;
+static std::map<std::string, std::shared_ptr<DeviceLock>> deviceLocks;
+static std::map<SoapySDR::Device *, DeviceIdentity> deviceIdentities;
+
+//released devices that are kept open, keyed by the identity key
+struct WarmDevice
+{
+    SoapySDR::Device *device;
+    DeviceIdentity identity;
+    std::chrono::steady_clock::time_point expires;
+};
+static long long warmPoolTimeUs = 0;
+static std::multimap<std::string, WarmDevice> warmPool;
+
+class FactoryLock
+{
+public:
+    FactoryLock(const DeviceIdentity &identity)
+    {
+        std::unique_lock<std::mutex> lock(factoryMutex);
+        _exclusive = std::find(globalLockDrivers.begin(), globalLockDrivers.end(), identity.driver) != globalLockDrivers.end();
+        if (_exclusive)
+        {
+            factoryCond.wait(lock, []{return not factoryExclusive and factoryShared == 0;});
+            factoryExclusive = true;
+            return;
+        }
+
+        factoryCond.wait(lock, []{return not factoryExclusive;});
+        factoryShared++;
+        auto &deviceLock = deviceLocks[identity.key];
+        if (not deviceLock) deviceLock.reset(new DeviceLock());
+        deviceLock->users++;
+        _key = identity.key;
+        _deviceLock = deviceLock;
+        lock.unlock();
+        _deviceLock->mutex.lock();
+    }
+
+    ~FactoryLock(void)
+    {
+        if (_deviceLock) _deviceLock->mutex.unlock();
+        std::lock_guard<std::mutex> lock(factoryMutex);
+        if (_exclusive) factoryExclusive = false;
+        else
+        {
+            factoryShared--;
+            if (--_deviceLock->users == 0) deviceLocks.erase(_key);
+        }
+        factoryCond.notify_all();
+    }
+
+private:
+    bool _exclusive;
+    std::string _key;
+    std::shared_ptr<DeviceLock> _deviceLock;
+};
+
+/***********************************************************************
+ * identify the device from the args: a single enumerate match
+ * gives the driver and serial, otherwise the args are the key
+ **********************************************************************/
+static DeviceIdentity getDeviceIdentity(const SoapySDR::Kwargs &args)
+{
+    DeviceIdentity identity;
+    SoapySDR::Kwargs match(args);
+    const auto results = ServerEnumerateCache::enumerate(args);
+    if (results.size() == 1) match = results.front();
+
+    const auto driverIt = match.find("driver");
+    if (driverIt != match.end()) identity.driver = driverIt->second;
+    const auto serialIt = match.find("serial");
+    if (serialIt != match.end()) identity.key = identity.driver + ":" + serialIt->second;
+    else identity.key = SoapySDR::KwargsToString(match);
+    return identity;
+}
+
+/***********************************************************************
+ * factory implementation
+ **********************************************************************/
+void ServerDeviceFactory::setGlobalLockDrivers(const std::vector<std::string> &drivers)
+{
+    std::lock_guard<std::mutex> lock(factoryMutex);
+    globalLockDrivers = drivers;
+}
+
+void ServerDeviceFactory::setWarmPoolTime(const long long timeUs)
+{
+    std::lock_guard<std::mutex> lock(factoryMutex);
+    warmPoolTimeUs = timeUs;
+}
+
+static void unmakeDevice(SoapySDR::Device *device, const DeviceIdentity &identity)
+{
+    {
+        FactoryLock lock(identity);
+        SoapySDR::Device::unmake(device);
+    }
+    ServerEnumerateCache::invalidate();
+}
+
+SoapySDR::Device *ServerDeviceFactory::make(const SoapySDR::Kwargs &args)
+{
+    const auto argsKey = SoapySDR::KwargsToString(args);
+    auto identity = getDeviceIdentity(args);
+    identity.args = argsKey;
+
+    //reuse a released device with the same identity, so that args
+    //from enumerate results match a device made with fewer args;
+    //drivers that hide open devices from enumerate match by args
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex);
+        auto it = warmPool.find(identity.key);
+        if (it == warmPool.end()) it = std::find_if(warmPool.begin(), warmPool.end(),
+            [&argsKey](const std::pair<const std::string, WarmDevice> &warm){return warm.second.identity.args == argsKey;});
+        if (it != warmPool.end())
+        {
+            auto device = it->second.device;
+            deviceIdentities[device] = it->second.identity;
+            deviceIdentities[device].refs = 1;
+            SoapySDR::logf(SOAPY_SDR_INFO, "SoapyServer: reusing warm device %s", it->second.identity.args.c_str());
+            warmPool.erase(it);
+            return device;
+        }
+    }
+
+    SoapySDR::Device *device = nullptr;
+    {
+        FactoryLock lock(identity);
+        device = SoapySDR::Device::make(args);
+    }
+
+    std::lock_guard<std::mutex> lock(factoryMutex);
+    auto &entry = deviceIdentities[device];
+    if (entry.refs == 0)
+    {
+        entry.driver = identity.driver;
+        entry.key = identity.key;
+        entry.args = identity.args;
+    }
+    entry.refs++;
+    ServerEnumerateCache::invalidate();
+    return device;
+}
+
+void ServerDeviceFactory::unmake(SoapySDR::Device *device)
+{
+    DeviceIdentity identity;
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex);
+        auto it = deviceIdentities.find(device);
+        if (it != deviceIdentities.end())
+        {
+            identity = it->second;
+            if (--it->second.refs == 0) deviceIdentities.erase(it);
+        }
+
+        //park the last user's device rather than closing it,
+        //the client handler has already closed the streams
+        if (identity.refs == 1 and warmPoolTimeUs > 0)
+        {
+            WarmDevice warm;
+            warm.device = device;
+            warm.identity = identity;
+            warm.expires = std::chrono::steady_clock::now() + std::chrono::microseconds(warmPoolTimeUs);
+            warmPool.insert(std::make_pair(identity.key, warm));
+            return;
+        }
+    }
+
+    unmakeDevice(device, identity);
+}
+
+void ServerDeviceFactory::preopen(const SoapySDR::Kwargs &args)
+{
+    auto device = ServerDeviceFactory::make(args);
+
+    //park the device until a client makes it, the grace period
+    //only starts when a client releases the device afterwards
+    std::lock_guard<std::mutex> lock(factoryMutex);
+    auto it = deviceIdentities.find(device);
+    WarmDevice warm;
+    warm.device = device;
+    warm.identity = it->second;
+    warm.expires = std::chrono::steady_clock::time_point::max();
+    if (--it->second.refs == 0) deviceIdentities.erase(it);
+    warmPool.insert(std::make_pair(warm.identity.key, warm));
+}
+
+void ServerDeviceFactory::reapWarmPool(const bool all)
+{
+    std::vector<WarmDevice> expired;
+    {
+        std::lock_guard<std::mutex> lock(factoryMutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = warmPool.begin(); it != warmPool.end();)
+        {
+            if (not all and now < it->second.expires) ++it;
+            else
+            {
+                expired.push_back(it->second);
+                it = warmPool.erase(it);
+            }
+        }
+    }
+
+    for (const auto &warm : expired)
+    {
+        SoapySDR::logf(SOAPY_SDR_INFO, "SoapyServer: closing warm device %s", warm.identity.args.c_str());
+        unmakeDevice(warm.device, warm.identity);
+    }
+}
+
+/***********************************************************************
+ * warm pool reaper thread
+ **********************************************************************/
+ServerWarmPoolReaper::ServerWarmPoolReaper(void):
+    _done(false)
+{
+    _thread = std::thread(&ServerWarmPoolReaper::reapLoop, this);
+}
+
+ServerWarmPoolReaper::~ServerWarmPoolReaper(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _cond.notify_all();
+    }
+    _thread.join();
+}
+
+void ServerWarmPoolReaper::reapLoop(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (not _done)
+    {
+        _cond.wait_for(lock, std::chrono::microseconds(SOAPY_REMOTE_SOCKET_TIMEOUT_US));
+        if (_done) break;
+        lock.unlock();
+        ServerDeviceFactory::reapWarmPool();
+        lock.lock();
+    }
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <SoapySDR/Types.hpp>
+#include <condition_variable>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+namespace SoapySDR
+{
+    class Device;
+}
+
+/*!
+ * Make and unmake devices for the client handlers.
+ * Devices with different identities (driver and serial from enumerate)
+ * open and close in parallel; requests for the same device serialize.
+ * Drivers that are not reentrant take a lock over the whole factory.
+ *
+ * With the warm pool enabled, the last unmake of a device keeps it
+ * open for a grace period and a make of the same device reuses it
+ * (the same identity, or the same args when enumerate hides it).
+ */
+class ServerDeviceFactory
+{
+public:
+    //! Set the drivers that make and unmake under the global lock
+    static void setGlobalLockDrivers(const std::vector<std::string> &drivers);
+
+    //! Set the warm pool grace period in microseconds (0 disables)
+    static void setWarmPoolTime(const long long timeUs);
+
+    //! Make a device, throws on failure
+    static SoapySDR::Device *make(const SoapySDR::Kwargs &args);
+
+    //! Unmake a device from make()
+    static void unmake(SoapySDR::Device *device);
+
+    //! Make a device at startup and keep it in the warm pool until used
+    static void preopen(const SoapySDR::Kwargs &args);
+
+    //! Close warm devices past the grace period, or all of them
+    static void reapWarmPool(const bool all = false);
+};
+
+/*!
+ * Reap the warm pool on a thread of its own:
+ * driver unmake can take seconds and would stall the accept loop.
+ */
+class ServerWarmPoolReaper
+{
+public:
+    ServerWarmPoolReaper(void);
+
+    //! Stops the thread, warm devices stay open until reapWarmPool(true)
+    ~ServerWarmPoolReaper(void);
+
+private:
+    void reapLoop(void);
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _done;
+    std::thread _thread;
+};
@@ -0,0 +1,98 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "EnumerateCache.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Device.hpp>
+#include <condition_variable>
+#include <chrono>
+#include <mutex>
+#include <map>
+
+/***********************************************************************
+ * cache storage
+ **********************************************************************/
+struct ServerEnumerateEntry
+{
+    ServerEnumerateEntry(void):
+        valid(false),
+        busy(false)
+    {
+        return;
+    }
+
+    SoapySDR::KwargsList result;
+    std::chrono::steady_clock::time_point expires;
+    bool valid;
+    bool busy; //an enumerate is in progress
+};
+
+static std::mutex cacheMutex;
+static std::condition_variable cacheCond;
+static std::map<std::string, ServerEnumerateEntry> cacheEntries;
+static long long cacheTTLUs = SOAPY_REMOTE_SERVER_ENUMERATE_TTL_US;
+static unsigned cacheGeneration = 0;
+
+/***********************************************************************
+ * cache implementation
+ **********************************************************************/
+void ServerEnumerateCache::setTTL(const long long ttlUs)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheTTLUs = ttlUs;
+    cacheEntries.clear();
+}
+
+SoapySDR::KwargsList ServerEnumerateCache::enumerate(const SoapySDR::Kwargs &args)
+{
+    std::unique_lock<std::mutex> lock(cacheMutex);
+    if (cacheTTLUs <= 0)
+    {
+        lock.unlock();
+        return SoapySDR::Device::enumerate(args);
+    }
+
+    //wait out another enumerate with the same args
+    auto &entry = cacheEntries[SoapySDR::KwargsToString(args)];
+    cacheCond.wait(lock, [&entry]{return not entry.busy;});
+    if (entry.valid and std::chrono::steady_clock::now() < entry.expires) return entry.result;
+
+    //enumerate without the lock, the entry stays in the map while busy
+    entry.busy = true;
+    const auto generation = cacheGeneration;
+    lock.unlock();
+    SoapySDR::KwargsList result;
+    try
+    {
+        result = SoapySDR::Device::enumerate(args);
+    }
+    catch (...)
+    {
+        lock.lock();
+        entry.busy = false;
+        cacheCond.notify_all();
+        throw;
+    }
+    lock.lock();
+
+    //results from before an invalidation are returned but not kept
+    entry.busy = false;
+    entry.valid = (generation == cacheGeneration);
+    entry.result = result;
+    entry.expires = std::chrono::steady_clock::now() + std::chrono::microseconds(cacheTTLUs);
+    cacheCond.notify_all();
+    return result;
+}
+
+void ServerEnumerateCache::invalidate(void)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheGeneration++;
+    for (auto &entry : cacheEntries) entry.second.valid = false;
+}
+
+unsigned ServerEnumerateCache::generation(void)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cacheGeneration;
+}
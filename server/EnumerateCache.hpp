@@ -0,0 +1,30 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <SoapySDR/Types.hpp>
+
+/*!
+ * The server-wide cache of SoapySDR::Device::enumerate() results.
+ * Results are shared by all client handlers and keyed by the args.
+ * Concurrent requests for the same args wait on a single enumerate.
+ *
+ * Results expire after the TTL and all results are invalidated on
+ * device make/unmake and on hotplug events. Each invalidation bumps
+ * the generation, which the server advertises as its SSDP config ID.
+ */
+class ServerEnumerateCache
+{
+public:
+    //! Set the time to live of results in microseconds (0 disables)
+    static void setTTL(const long long ttlUs);
+
+    //! Enumerate through the cache
+    static SoapySDR::KwargsList enumerate(const SoapySDR::Kwargs &args);
+
+    //! Drop all cached results
+    static void invalidate(void);
+
+    //! The number of invalidations so far
+    static unsigned generation(void);
+};
@@ -0,0 +1,72 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "HotplugMonitor.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Logger.hpp>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cstring> //memset, strerror
+#include <cerrno> //errno
+#include <string>
+
+SoapyHotplugMonitor::SoapyHotplugMonitor(const std::function<void(void)> &callback):
+    _callback(callback),
+    _sock(-1),
+    _done(false)
+{
+    //subscribe to the kernel's uevent broadcast group
+    _sock = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    struct sockaddr_nl addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1;
+    if (_sock < 0 or bind(_sock, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        SoapySDR::logf(SOAPY_SDR_WARNING, "SoapyHotplugMonitor unavailable: %s", strerror(errno));
+        if (_sock >= 0) close(_sock);
+        _sock = -1;
+        return;
+    }
+
+    _thread = std::thread(&SoapyHotplugMonitor::monitorLoop, this);
+}
+
+SoapyHotplugMonitor::~SoapyHotplugMonitor(void)
+{
+    _done = true;
+    if (_thread.joinable()) _thread.join();
+    if (_sock >= 0) close(_sock);
+}
+
+void SoapyHotplugMonitor::monitorLoop(void)
+{
+    char buff[4096];
+    while (not _done)
+    {
+        struct pollfd pfd;
+        pfd.fd = _sock;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, SOAPY_REMOTE_SOCKET_TIMEOUT_US/1000) <= 0) continue;
+        const ssize_t ret = recv(_sock, buff, sizeof(buff)-1, 0);
+        if (ret <= 0) continue;
+        buff[ret] = '\0';
+
+        //the message is "action@devpath" followed by KEY=VALUE strings
+        std::string action, subsystem;
+        for (ssize_t i = 0; i < ret; i += std::strlen(buff+i)+1)
+        {
+            const std::string field(buff+i);
+            if (field.find("ACTION=") == 0) action = field.substr(7);
+            if (field.find("SUBSYSTEM=") == 0) subsystem = field.substr(10);
+        }
+        if (action != "add" and action != "remove") continue;
+        if (subsystem != "usb" and subsystem != "pci") continue;
+
+        SoapySDR::logf(SOAPY_SDR_DEBUG, "SoapyHotplugMonitor: %s %s device", action.c_str(), subsystem.c_str());
+        _callback();
+    }
+}
@@ -0,0 +1,28 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <functional>
+#include <thread>
+#include <atomic>
+
+/*!
+ * Watch for devices being added or removed on the host
+ * and call the callback from the monitor thread for each event.
+ * On Linux this listens for kernel uevents (usb and pci);
+ * on other platforms the monitor does nothing.
+ */
+class SoapyHotplugMonitor
+{
+public:
+    SoapyHotplugMonitor(const std::function<void(void)> &callback);
+
+    ~SoapyHotplugMonitor(void);
+
+private:
+    void monitorLoop(void);
+    const std::function<void(void)> _callback;
+    int _sock;
+    std::atomic<bool> _done;
+    std::thread _thread;
+};
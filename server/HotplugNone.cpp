@@ -0,0 +1,22 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "HotplugMonitor.hpp"
+
+SoapyHotplugMonitor::SoapyHotplugMonitor(const std::function<void(void)> &callback):
+    _callback(callback),
+    _sock(-1),
+    _done(false)
+{
+    return;
+}
+
+SoapyHotplugMonitor::~SoapyHotplugMonitor(void)
+{
+    return;
+}
+
+void SoapyHotplugMonitor::monitorLoop(void)
+{
+    return;
+}
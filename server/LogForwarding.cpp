@@ -5,48 +5,377 @@
 #include "SoapyRemoteDefs.hpp"
 #include "SoapyRPCPacker.hpp"
 #include <SoapySDR/Logger.hpp>
+#include <condition_variable>
+#include <algorithm> //max
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include <mutex>
+#include <deque>
+#include <vector>
 #include <set>
+#include <map>
 
 /***********************************************************************
- * socket subscribers for log forwarding
+ * bounded lock-free queue between the log callback and the dispatcher:
+ * producers claim a cell with a CAS on the enqueue position and publish
+ * it with the cell sequence; there is a single consumer (the dispatcher)
  **********************************************************************/
-static std::mutex subscribersMutex;
+struct LogMessage
+{
+    SoapySDRLogLevel logLevel;
+    std::string message;
+};
+
+class LogMessageQueue
+{
+public:
+    LogMessageQueue(const size_t size):
+        _cells(size),
+        _enqueuePos(0),
+        _dequeuePos(0),
+        _dropped(0)
+    {
+        for (size_t i = 0; i < size; i++) _cells[i].sequence.store(i);
+    }
+
+    //called from any thread, drop the message when full
+    bool push(const SoapySDRLogLevel logLevel, const char *message)
+    {
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto &cell = _cells[pos % _cells.size()];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq == pos)
+            {
+                if (not _enqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)) continue;
+                cell.msg.logLevel = logLevel;
+                cell.msg.message = message;
+                cell.sequence.store(pos+1, std::memory_order_release);
+                return true;
+            }
+            if (seq < pos)
+            {
+                _dropped++;
+                return false;
+            }
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    //called from the dispatcher thread only
+    bool pop(LogMessage &msg)
+    {
+        auto &cell = _cells[_dequeuePos % _cells.size()];
+        if (cell.sequence.load(std::memory_order_acquire) != _dequeuePos+1) return false;
+        msg.logLevel = cell.msg.logLevel;
+        msg.message.swap(cell.msg.message);
+        cell.sequence.store(_dequeuePos+_cells.size(), std::memory_order_release);
+        _dequeuePos++;
+        return true;
+    }
 
-static std::set<SoapyRPCSocket *> subscribers;
+    //called from the dispatcher thread only
+    bool empty(void) const
+    {
+        return _cells[_dequeuePos % _cells.size()].sequence.load(std::memory_order_acquire) != _dequeuePos+1;
+    }
+
+    //the number of messages dropped since the last call
+    size_t takeDropped(void)
+    {
+        return _dropped.exchange(0);
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        LogMessage msg;
+    };
+    std::vector<Cell> _cells;
+    std::atomic<size_t> _enqueuePos;
+    size_t _dequeuePos;
+    std::atomic<size_t> _dropped;
+};
 
 /***********************************************************************
- * custom log handling
+ * socket subscribers for log forwarding:
+ * each subscriber has a bounded queue and a thread to send it,
+ * so a stalled client only fills its own queue
  **********************************************************************/
-static void handleLogMessage(const SoapySDRLogLevel logLevel, const char *message)
+struct LogSubscriber
+{
+    LogSubscriber(SoapyRPCSocket &sock, std::mutex *pushMutex):
+        sock(sock),
+        pushMutex(pushMutex),
+        maxQueue(SOAPY_REMOTE_LOG_QUEUE_SIZE),
+        dropOldest(true),
+        dropped(0),
+        totalDropped(0),
+        totalSent(0),
+        done(false),
+        replyPending(0),
+        replied(pushMutex != nullptr)
+    {
+        return;
+    }
+
+    void push(const LogMessage &msg);
+    void senderLoop(void);
+
+    SoapyRPCSocket &sock;
+    std::mutex *pushMutex; //pushed on the control socket when set
+    size_t maxQueue;
+    bool dropOldest;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<LogMessage> queue;
+    size_t dropped; //since the last send
+    size_t totalDropped;
+    size_t totalSent;
+    std::atomic<bool> done;
+    std::thread thread;
+
+    //send gate shared with the replies on the socket
+    std::mutex sendMutex;
+    std::condition_variable sendCond;
+    size_t replyPending;
+    bool replied; //log messages follow the reply to the start request
+};
+
+void LogSubscriber::push(const LogMessage &msg)
 {
-    std::string strMessage(message);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queue.size() >= maxQueue)
+    {
+        dropped++;
+        totalDropped++;
+        if (not dropOldest) return;
+        queue.pop_front();
+    }
+    queue.push_back(msg);
+    cond.notify_one();
+}
 
-    std::lock_guard<std::mutex> lock(subscribersMutex);
-    for (auto sock : subscribers)
+void LogSubscriber::senderLoop(void)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
     {
+        //flush the queue before exiting on stop
+        cond.wait(lock, [this]{return done or not queue.empty();});
+        if (queue.empty()) return;
+
+        //tell the client about messages that were dropped for it
+        LogMessage msg;
+        if (dropped != 0)
+        {
+            msg.logLevel = SOAPY_SDR_WARNING;
+            msg.message = "SoapyRemote: dropped " + std::to_string(dropped) + " log messages";
+            dropped = 0;
+        }
+        else
+        {
+            msg = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        //send without the lock so the dispatcher never waits on the socket,
+        //the send gate holds log messages while a reply is pending
+        lock.unlock();
         try
         {
-            SoapyRPCPacker packer(*sock);
-            packer & char(logLevel);
-            packer & strMessage;
-            packer();
+            std::unique_lock<std::mutex> sendLock(sendMutex);
+            sendCond.wait(sendLock, [this]{return (replied or done) and replyPending == 0;});
+            SoapyRPCPacker packer(sock);
+            if (pushMutex != nullptr) packer & SOAPY_REMOTE_PUSH_LOG;
+            packer & char(msg.logLevel);
+            packer & msg.message;
+            if (pushMutex == nullptr) packer();
+            else
+            {
+                std::lock_guard<std::mutex> pushLock(*pushMutex);
+                packer();
+            }
         }
         catch (...)
         {
             //ignored
         }
+        lock.lock();
+        totalSent++;
     }
 }
 
+/***********************************************************************
+ * the dispatcher thread moves messages from the log callback's queue
+ * into the queue of every subscriber
+ **********************************************************************/
+class LogDispatcher
+{
+public:
+    LogDispatcher(void):
+        _queue(SOAPY_REMOTE_LOG_RING_SIZE),
+        _sleeping(false),
+        _done(false)
+    {
+        _thread = std::thread(&LogDispatcher::dispatchLoop, this);
+    }
+
+    ~LogDispatcher(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done = true;
+            _cond.notify_all();
+        }
+        _thread.join();
+    }
+
+    void push(const SoapySDRLogLevel logLevel, const char *message)
+    {
+        if (not _queue.push(logLevel, message)) return;
+
+        //only take the lock when the dispatcher may be sleeping
+        if (not _sleeping.load()) return;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cond.notify_one();
+    }
+
+    void subscribe(LogSubscriber *subscriber)
+    {
+        std::lock_guard<std::mutex> lock(_subscribersMutex);
+        _subscribers.insert(subscriber);
+    }
+
+    void unsubscribe(LogSubscriber *subscriber)
+    {
+        std::lock_guard<std::mutex> lock(_subscribersMutex);
+        _subscribers.erase(subscriber);
+    }
+
+private:
+    void dispatchLoop(void)
+    {
+        LogMessage msg;
+        while (not _done)
+        {
+            //summarize the SSI markers at the end of each interval
+            const auto now = std::chrono::steady_clock::now();
+            if (not _ssiCounts.empty() and now >= _ssiDeadline) this->flushMarkers();
+
+            if (not _queue.pop(msg))
+            {
+                //sleep until a push or the end of the marker interval,
+                //the timeout covers a missed notify
+                auto timeout = std::chrono::steady_clock::duration(std::chrono::microseconds(SOAPY_REMOTE_SOCKET_TIMEOUT_US));
+                if (not _ssiCounts.empty()) timeout = std::min(timeout, _ssiDeadline - now);
+                std::unique_lock<std::mutex> lock(_mutex);
+                _sleeping = true;
+                if (not _done and _queue.empty()) _cond.wait_for(lock, timeout);
+                _sleeping = false;
+                continue;
+            }
+
+            //count the overflow, underflow, and sequence markers,
+            //the first marker in an interval starts the interval
+            if (msg.logLevel == SOAPY_SDR_SSI)
+            {
+                if (_ssiCounts.empty()) _ssiDeadline = now + std::chrono::microseconds(SOAPY_REMOTE_LOG_SSI_INTERVAL_US);
+                for (const auto ch : msg.message) _ssiCounts[ch]++;
+                continue;
+            }
+
+            this->dispatch(msg);
+        }
+    }
+
+    void flushMarkers(void)
+    {
+        for (const auto &entry : _ssiCounts)
+        {
+            //a lone marker is forwarded as-is, repeats as a counted summary
+            LogMessage msg;
+            msg.logLevel = SOAPY_SDR_SSI;
+            msg.message = std::string(1, entry.first);
+            if (entry.second > 1)
+            {
+                msg.logLevel = SOAPY_SDR_NOTICE;
+                msg.message += " x" + std::to_string(entry.second) +
+                    " in " + std::to_string(SOAPY_REMOTE_LOG_SSI_INTERVAL_US/1000) + "ms";
+            }
+            this->dispatch(msg);
+        }
+        _ssiCounts.clear();
+    }
+
+    void dispatch(const LogMessage &msg)
+    {
+        //messages lost in the callback queue go to every subscriber
+        std::lock_guard<std::mutex> lock(_subscribersMutex);
+        const size_t dropped = _queue.takeDropped();
+        for (auto subscriber : _subscribers)
+        {
+            if (dropped != 0)
+            {
+                std::lock_guard<std::mutex> subLock(subscriber->mutex);
+                subscriber->dropped += dropped;
+                subscriber->totalDropped += dropped;
+            }
+            subscriber->push(msg);
+        }
+    }
+
+    LogMessageQueue _queue;
+    std::atomic<bool> _sleeping;
+    std::atomic<bool> _done;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread _thread;
+
+    std::mutex _subscribersMutex;
+    std::set<LogSubscriber *> _subscribers;
+
+    //SSI marker counts for the current interval (dispatcher thread)
+    std::map<char, size_t> _ssiCounts;
+    std::chrono::steady_clock::time_point _ssiDeadline;
+};
+
+static LogDispatcher &getLogDispatcher(void)
+{
+    static LogDispatcher dispatcher;
+    return dispatcher;
+}
+
+/***********************************************************************
+ * custom log handling: never blocks the logging thread
+ **********************************************************************/
+static void handleLogMessage(const SoapySDRLogLevel logLevel, const char *message)
+{
+    getLogDispatcher().push(logLevel, message);
+}
+
 /***********************************************************************
  * subscriber reregistration entry points
  **********************************************************************/
-SoapyLogForwarder::SoapyLogForwarder(SoapyRPCSocket &sock):
-    _sock(sock)
+SoapyLogForwarder::SoapyLogForwarder(SoapyRPCSocket &sock, const SoapySDR::Kwargs &args, std::mutex *pushMutex):
+    _subscriber(nullptr)
 {
-    std::lock_guard<std::mutex> lock(subscribersMutex);
-    subscribers.insert(&_sock);
+    //parse the args first, malformed values throw before any allocation
+    const auto queueIt = args.find(SOAPY_REMOTE_KWARG_LOG_QUEUE);
+    const size_t maxQueue = (queueIt == args.end())?0:std::max<size_t>(1, std::stoul(queueIt->second));
+    const auto dropIt = args.find(SOAPY_REMOTE_KWARG_LOG_DROP);
+
+    _subscriber = new LogSubscriber(sock, pushMutex);
+    if (maxQueue != 0) _subscriber->maxQueue = maxQueue;
+    if (dropIt != args.end()) _subscriber->dropOldest = (dropIt->second != "newest");
+
+    _subscriber->thread = std::thread(&LogSubscriber::senderLoop, _subscriber);
+    getLogDispatcher().subscribe(_subscriber);
 
     //register the log handler, its safe to re-register every time
     SoapySDR::registerLogHandler(&handleLogMessage);
@@ -54,6 +383,36 @@ SoapyLogForwarder::SoapyLogForwarder(SoapyRPCSocket &sock):
 
 SoapyLogForwarder::~SoapyLogForwarder(void)
 {
-    std::lock_guard<std::mutex> lock(subscribersMutex);
-    subscribers.erase(&_sock);
+    getLogDispatcher().unsubscribe(_subscriber);
+    {
+        std::lock_guard<std::mutex> lock(_subscriber->mutex);
+        _subscriber->done = true;
+        _subscriber->cond.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_subscriber->sendMutex);
+        _subscriber->sendCond.notify_all();
+    }
+    _subscriber->thread.join();
+
+    if (_subscriber->totalDropped != 0) SoapySDR::logf(SOAPY_SDR_DEBUG,
+        "SoapyLogForwarder: sent %d, dropped %d log messages",
+        int(_subscriber->totalSent), int(_subscriber->totalDropped));
+    delete _subscriber;
+}
+
+void SoapyLogForwarder::beginReply(void)
+{
+    //stop the send thread from starting another message,
+    //then wait for the socket to be free of the current message
+    std::lock_guard<std::mutex> lock(_subscriber->sendMutex);
+    _subscriber->replyPending++;
+}
+
+void SoapyLogForwarder::endReply(void)
+{
+    std::lock_guard<std::mutex> lock(_subscriber->sendMutex);
+    _subscriber->replyPending--;
+    _subscriber->replied = true;
+    _subscriber->sendCond.notify_all();
 }
@@ -3,16 +3,33 @@
 
 #pragma once
 #include "SoapyRPCSocket.hpp"
+#include <SoapySDR/Types.hpp>
+#include <mutex>
+
+struct LogSubscriber;
 
 /*!
  * Create a log forwarder to subscribe to log events from the local logger.
+ * The log callback only enqueues the message; a dispatcher thread fans the
+ * messages out to each subscriber's bounded queue and send thread.
+ * The args select the queue size and drop policy of this subscriber.
+ * With a push mutex, the messages are pushed on the control socket
+ * between the replies and other pushes sent under the same mutex.
  */
 class SoapyLogForwarder
 {
 public:
-    SoapyLogForwarder(SoapyRPCSocket &sock);
+    SoapyLogForwarder(SoapyRPCSocket &sock, const SoapySDR::Kwargs &args = SoapySDR::Kwargs(), std::mutex *pushMutex = nullptr);
     ~SoapyLogForwarder(void);
 
+    /*!
+     * Replies take priority over log messages on the socket:
+     * call around sending a reply to hold the log messages.
+     * Log messages start after the reply to the start request.
+     */
+    void beginReply(void);
+    void endReply(void);
+
 private:
-    SoapyRPCSocket &_sock;
+    LogSubscriber *_subscriber;
 };
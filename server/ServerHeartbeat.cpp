@@ -0,0 +1,83 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ServerHeartbeat.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include "SoapyRPCPacker.hpp"
+#include <SoapySDR/Logger.hpp>
+#include <chrono>
+
+ServerHeartbeat::ServerHeartbeat(SoapyRPCSocket &sock, std::mutex &sendMutex, const unsigned int remoteRPCVersion):
+    _sock(sock),
+    _sendMutex(sendMutex),
+    _remoteRPCVersion(remoteRPCVersion),
+    _calls(0),
+    _busy(false),
+    _done(false)
+{
+    _thread = std::thread(&ServerHeartbeat::heartbeatLoop, this);
+}
+
+ServerHeartbeat::~ServerHeartbeat(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _cond.notify_all();
+    }
+    _thread.join();
+}
+
+void ServerHeartbeat::begin(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _calls++;
+    _busy = true;
+    _cond.notify_all();
+}
+
+void ServerHeartbeat::end(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _busy = false;
+    _cond.notify_all();
+}
+
+void ServerHeartbeat::heartbeatLoop(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (not _done)
+    {
+        if (not _busy)
+        {
+            _cond.wait(lock);
+            continue;
+        }
+
+        //wait out one period of the call
+        const auto calls = _calls;
+        _cond.wait_for(lock, std::chrono::microseconds(SOAPY_REMOTE_HEARTBEAT_PERIOD_US));
+        if (_done or not _busy or _calls != calls) continue;
+
+        //the reply is sent under the send mutex after end(),
+        //so checking again with the send mutex held keeps
+        //heartbeats from following the reply of their call
+        lock.unlock();
+        std::lock_guard<std::mutex> sendLock(_sendMutex);
+        lock.lock();
+        if (not _busy or _calls != calls) continue;
+
+        try
+        {
+            SoapyRPCPacker packer(_sock, _remoteRPCVersion);
+            packer & SOAPY_REMOTE_HEARTBEAT;
+            packer();
+        }
+        catch (const std::exception &ex)
+        {
+            //the client handler sees the same socket error
+            SoapySDR::logf(SOAPY_SDR_ERROR, "ServerHeartbeat FAIL: %s", ex.what());
+            return;
+        }
+    }
+}
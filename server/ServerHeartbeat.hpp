@@ -0,0 +1,42 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+
+class SoapyRPCSocket;
+
+/*!
+ * Push heartbeats to the client while a call is in progress.
+ * The client knows that a long call is still running from the
+ * heartbeats instead of probing the server with new connections.
+ */
+class ServerHeartbeat
+{
+public:
+    ServerHeartbeat(SoapyRPCSocket &sock, std::mutex &sendMutex, const unsigned int remoteRPCVersion);
+
+    ~ServerHeartbeat(void);
+
+    //! A call started, heartbeats are pushed at every period until it ends
+    void begin(void);
+
+    //! The call ended, this must happen before the reply is sent
+    void end(void);
+
+private:
+    void heartbeatLoop(void);
+
+    SoapyRPCSocket &_sock;
+    std::mutex &_sendMutex;
+    const unsigned int _remoteRPCVersion;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    unsigned long long _calls;
+    bool _busy;
+    bool _done;
+    std::thread _thread;
+};
@@ -0,0 +1,89 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ServerStatusChannel.hpp"
+#include "ServerStreamData.hpp"
+#include "SoapyStreamEndpoint.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm> //max
+#include <stdexcept>
+
+//the shortest readStreamStatus() timeout when polling many streams
+#define STATUS_CHANNEL_MIN_TIMEOUT_US 1000
+
+ServerStatusChannel::ServerStatusChannel(const std::string &connectURL):
+    _busyId(-1),
+    _done(false)
+{
+    int ret = _sock.connect(connectURL);
+    if (ret != 0) throw std::runtime_error(
+        "SoapyRemote::setupStatusChannel("+connectURL+") -- connect FAIL: " + std::string(_sock.lastErrorMsg()));
+    SoapySDR::logf(SOAPY_SDR_INFO, "Server side status channel connected to %s", _sock.getpeername().c_str());
+
+    _thread = std::thread(&ServerStatusChannel::statusWork, this);
+}
+
+ServerStatusChannel::~ServerStatusChannel(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _cond.notify_all();
+    }
+    _thread.join();
+}
+
+void ServerStatusChannel::add(ServerStreamData *data)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _streams[data->streamId] = data;
+    _cond.notify_all();
+}
+
+void ServerStatusChannel::remove(const int streamId)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _streams.erase(streamId);
+    _cond.wait(lock, [&]{return _busyId != streamId;});
+}
+
+void ServerStatusChannel::statusWork(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    int lastId = -1;
+
+    while (not _done)
+    {
+        if (_streams.empty())
+        {
+            _cond.wait(lock);
+            continue;
+        }
+
+        //visit the streams in turn, the timeout is shared between them
+        //so each stream is polled at least as often as a dedicated thread
+        auto it = _streams.upper_bound(lastId);
+        if (it == _streams.end()) it = _streams.begin();
+        auto data = it->second;
+        lastId = _busyId = data->streamId;
+        const long timeoutUs = std::max<long>(STATUS_CHANNEL_MIN_TIMEOUT_US,
+            SOAPY_REMOTE_SOCKET_TIMEOUT_US/long(_streams.size()));
+
+        //read the status without the lock so streams can be added
+        lock.unlock();
+        size_t chanMask = 0;
+        int flags = 0;
+        long long timeNs = 0;
+        const int ret = data->device->readStreamStatus(data->stream, chanMask, flags, timeNs, timeoutUs);
+        if (ret != SOAPY_SDR_TIMEOUT) data->endpoint->writeStatus(ret, chanMask, flags, timeNs);
+        lock.lock();
+
+        //stop polling if stream status is not supported
+        //but only after reporting this to the local endpoint
+        if (ret == SOAPY_SDR_NOT_SUPPORTED) _streams.erase(data->streamId);
+        _busyId = -1;
+        _cond.notify_all();
+    }
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include "SoapyRPCSocket.hpp"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+
+class ServerStreamData;
+
+/*!
+ * The status channel serves the stream status of every stream on a
+ * client connection with a single thread and a single datagram socket.
+ * The thread polls readStreamStatus() on each stream in turn and
+ * forwards the result tagged with the stream ID (see writeStatus()).
+ */
+class ServerStatusChannel
+{
+public:
+    //! Connect the channel to the client's bound status port
+    ServerStatusChannel(const std::string &connectURL);
+
+    ~ServerStatusChannel(void);
+
+    //! The connected socket shared by the stream endpoints
+    SoapyRPCSocket &socket(void)
+    {
+        return _sock;
+    }
+
+    //! Start polling the status of a stream with an endpoint
+    void add(ServerStreamData *data);
+
+    //! Stop polling a stream, returns after any call in progress
+    void remove(const int streamId);
+
+private:
+    void statusWork(void);
+
+    SoapyRPCSocket _sock;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::map<int, ServerStreamData *> _streams;
+    int _busyId; //stream ID in readStreamStatus() or -1
+    bool _done;
+    std::thread _thread;
+};
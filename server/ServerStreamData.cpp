@@ -5,11 +5,17 @@
 #include "ServerStreamData.hpp"
 #include "SoapyRemoteDefs.hpp"
 #include "SoapyStreamEndpoint.hpp"
+#include "SoapySocketPool.hpp"
+#include "StreamHistory.hpp"
+#include "StreamRecorder.hpp"
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Logger.hpp>
 #include <algorithm> //min
 #include <thread>
 #include <vector>
+#include <chrono>
+#include <cstring> //memcpy
 #include <cassert>
 
 template <typename T>
@@ -24,37 +30,73 @@ void incrementBuffs(std::vector<T> &buffs, size_t numElems, size_t elemSize)
 ServerStreamData::ServerStreamData(void):
     device(nullptr),
     stream(nullptr),
+    direction(0),
     chanMask(0),
     priority(0.0),
+    jitterElems(0),
+    jitterRate(0.0),
     streamId(-1),
     streamSock(nullptr),
     statusSock(nullptr),
+    socketPool(nullptr),
+    useStatusChannel(false),
     endpoint(nullptr),
+    replay(false),
+    recordOnly(false),
     streamThread(nullptr),
     statusThread(nullptr),
-    done(true)
+    readerThread(nullptr),
+    done(true),
+    readerError(0),
+    replayActive(false),
+    replayIndex(0),
+    replayEnd(0),
+    playRepeat(0),
+    playFlags(0),
+    playTimeNs(0),
+    playStop(false)
 {
     return;
 }
 
 ServerStreamData::~ServerStreamData(void)
 {
-    delete streamSock;
-    delete statusSock;
+    delete endpoint;
+    //the unused status socket of a status channel stream is not pooled
+    if (socketPool != nullptr and useStatusChannel)
+    {
+        socketPool->release(streamSock, nullptr);
+        delete statusSock;
+    }
+    else if (socketPool != nullptr) socketPool->release(streamSock, statusSock);
+    else
+    {
+        delete streamSock;
+        delete statusSock;
+    }
+    for (auto sock : stripeSocks) delete sock;
 }
 
 void ServerStreamData::startSendThread(void)
 {
     assert(streamId != -1);
     done = false;
-    streamThread = new std::thread(&ServerStreamData::sendEndpointWork, this);
+
+    //the history is filled by the reader whether or not the client keeps up
+    if (history)
+    {
+        readerThread = new std::thread(&ServerStreamData::readerWork, this);
+        streamThread = new std::thread(&ServerStreamData::historyEndpointWork, this);
+    }
+    else streamThread = new std::thread(&ServerStreamData::sendEndpointWork, this);
 }
 
 void ServerStreamData::startRecvThread(void)
 {
     assert(streamId != -1);
     done = false;
-    streamThread = new std::thread(&ServerStreamData::recvEndpointWork, this);
+    if (jitterElems != 0) streamThread = new std::thread(&ServerStreamData::recvJitterEndpointWork, this);
+    else streamThread = new std::thread(&ServerStreamData::recvEndpointWork, this);
 }
 
 void ServerStreamData::startStatThread(void)
@@ -64,9 +106,34 @@ void ServerStreamData::startStatThread(void)
     statusThread = new std::thread(&ServerStreamData::statEndpointWork, this);
 }
 
-void ServerStreamData::stopThreads(void)
+void ServerStreamData::startReplayThread(void)
 {
+    assert(streamId != -1);
+    assert(history);
+    done = false;
+    streamThread = new std::thread(&ServerStreamData::replayEndpointWork, this);
+}
+
+void ServerStreamData::startReaderThread(void)
+{
+    assert(streamId != -1);
+    done = false;
+    readerThread = new std::thread(&ServerStreamData::readerWork, this);
+}
+
+void ServerStreamData::signalStop(void)
+{
+    //wake the threads out of their endpoint and replay waits,
+    //driver calls return within SOAPY_REMOTE_DEVICE_TIMEOUT_US
     done = true;
+    if (endpoint != nullptr) endpoint->interrupt();
+    std::lock_guard<std::mutex> lock(replayMutex);
+    replayCond.notify_all();
+}
+
+void ServerStreamData::stopThreads(void)
+{
+    this->signalStop();
     if (streamThread != nullptr)
     {
         streamThread->join();
@@ -77,6 +144,11 @@ void ServerStreamData::stopThreads(void)
         statusThread->join();
         delete statusThread;
     }
+    if (readerThread != nullptr)
+    {
+        readerThread->join();
+        delete readerThread;
+    }
 }
 
 static void setThreadPrioWithLogging(const double priority)
@@ -98,7 +170,6 @@ void ServerStreamData::recvEndpointWork(void)
     size_t handle = 0;
     int flags = 0;
     long long timeNs = 0;
-    const auto elemSize = endpoint->getElemSize();
     std::vector<const void *> buffs(endpoint->getNumChans());
 
     //loop forever until signaled done
@@ -108,6 +179,10 @@ void ServerStreamData::recvEndpointWork(void)
     //4) release the buffer back to the endpoint
     while (not done)
     {
+        //cached waveform playback takes priority over the endpoint,
+        //samples from the client wait in the socket until it completes
+        if (this->playbackWork()) continue;
+
         if (not endpoint->waitRecv(SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
         ret = endpoint->acquireRecv(handle, buffs.data(), flags, timeNs);
         if (ret < 0)
@@ -117,30 +192,241 @@ void ServerStreamData::recvEndpointWork(void)
         }
 
         //loop to write to device
-        size_t elemsLeft = size_t(ret);
-        while (not done)
+        this->writeDevice(buffs, size_t(ret), flags, timeNs);
+
+        //release the buffer back to the endpoint
+        endpoint->releaseRecv(handle);
+    }
+}
+
+void ServerStreamData::writeDevice(std::vector<const void *> &buffs, size_t elemsLeft, int flags, const long long timeNs)
+{
+    const auto elemSize = endpoint->getElemSize();
+    while (not done)
+    {
+        int ret = device->writeStream(stream, buffs.data(), elemsLeft, flags, timeNs, SOAPY_REMOTE_DEVICE_TIMEOUT_US);
+        if (ret == SOAPY_SDR_TIMEOUT) continue;
+        if (ret < 0)
         {
-            ret = device->writeStream(stream, buffs.data(), elemsLeft, flags, timeNs, SOAPY_REMOTE_SOCKET_TIMEOUT_US);
-            if (ret == SOAPY_SDR_TIMEOUT) continue;
+            endpoint->writeStatus(ret, chanMask, flags, timeNs);
+            break; //discard after error, this may have been invalid flags or time
+        }
+        if (elemsLeft < (size_t)ret)
+        {
+            SoapySDR_logf(SOAPY_SDR_ERROR, "Server-side receive endpoint: device->writeStream wrote more elements than requested");
+            break; //stop after error
+        }
+        elemsLeft -= ret;
+        incrementBuffs(buffs, ret, elemSize);
+        if (elemsLeft == 0) break;
+        flags &= ~(SOAPY_SDR_HAS_TIME); //clear time for subsequent writes
+    }
+}
+
+void ServerStreamData::recvJitterEndpointWork(void)
+{
+    setThreadPrioWithLogging(priority);
+    assert(endpoint != nullptr);
+    assert(endpoint->getElemSize() != 0);
+    assert(endpoint->getNumChans() != 0);
+    assert(jitterElems != 0);
+
+    //setup worker data structures
+    int ret = 0;
+    size_t handle = 0;
+    int flags = 0;
+    long long timeNs = 0;
+    const auto elemSize = endpoint->getElemSize();
+    const auto numChans = endpoint->getNumChans();
+    const auto buffSize = endpoint->getBuffSize();
+    std::vector<const void *> buffs(numChans);
+
+    //the target adapts between the configured fill and this maximum
+    const size_t minTarget = jitterElems;
+    const size_t maxTarget = minTarget*SOAPY_REMOTE_JITTER_MAX_GROWTH;
+    size_t target = minTarget;
+    const auto fillTimeout = std::chrono::microseconds((long long)(1e6*minTarget/jitterRate));
+
+    //preallocate the packet ring to hold the maximum target
+    struct JitterPacket
+    {
+        std::vector<char> buff;
+        size_t numElems;
+        int flags;
+        long long timeNs;
+    };
+    std::vector<JitterPacket> ring((maxTarget+buffSize-1)/buffSize + 1);
+    for (auto &packet : ring) packet.buff.resize(numChans*buffSize*elemSize);
+    size_t head = 0, count = 0, queuedElems = 0, queuedBurstEnds = 0;
+
+    //fill and adaptation state
+    bool filling = true;
+    bool inBurst = false;
+    auto fillStart = std::chrono::high_resolution_clock::now();
+    size_t packetsSinceUnderrun = 0;
+    size_t numUnderruns = 0;
+
+    //loop forever until signaled done
+    //1) drain the endpoint into the jitter buffer without blocking the device
+    //2) detect the jitter buffer running dry during a burst
+    //3) hold the writes until the buffer reaches the target fill
+    //4) write the oldest packet to the device stream
+    while (not done)
+    {
+        if (this->playbackWork()) continue;
+
+        //the buffer ran dry between bursts, refill before the next burst
+        if (not filling and count == 0 and not inBurst) filling = true;
+
+        //only block on the socket when there is nothing to write,
+        //a buffer that ran dry in a burst only drains what already arrived
+        const bool dry = (not filling and count == 0);
+        long timeoutUs = 0;
+        if (count == 0 and not dry) timeoutUs = SOAPY_REMOTE_SOCKET_TIMEOUT_US;
+        else if (filling) timeoutUs = SOAPY_REMOTE_JITTER_POLL_US;
+        while (count != ring.size() and endpoint->waitRecv(timeoutUs))
+        {
+            timeoutUs = 0;
+            ret = endpoint->acquireRecv(handle, buffs.data(), flags, timeNs);
             if (ret < 0)
             {
-                endpoint->writeStatus(ret, chanMask, flags, timeNs);
-                break; //discard after error, this may have been invalid flags or time
+                SoapySDR::logf(SOAPY_SDR_ERROR, "Server-side receive endpoint: %s; worker quitting...", streamSock->lastErrorMsg());
+                return;
             }
-            if (elemsLeft < (size_t)ret)
+
+            //copy into the jitter buffer and release the endpoint
+            if (filling and count == 0) fillStart = std::chrono::high_resolution_clock::now();
+            auto &packet = ring[(head+count)%ring.size()];
+            for (size_t i = 0; i < numChans; i++)
             {
-                SoapySDR_logf(SOAPY_SDR_ERROR, "Server-side receive endpoint: device->writeStream wrote more elements than requested");
-                break; //stop after error
+                std::memcpy(packet.buff.data()+(i*buffSize*elemSize), buffs[i], size_t(ret)*elemSize);
             }
-            elemsLeft -= ret;
-            incrementBuffs(buffs, ret, elemSize);
-            if (elemsLeft == 0) break;
-            flags &= ~(SOAPY_SDR_HAS_TIME); //clear time for subsequent writes
+            packet.numElems = size_t(ret);
+            packet.flags = flags;
+            packet.timeNs = timeNs;
+            endpoint->releaseRecv(handle);
+            count++;
+            queuedElems += packet.numElems;
+            if ((flags & SOAPY_SDR_END_BURST) != 0) queuedBurstEnds++;
         }
 
-        //release the buffer back to the endpoint
-        endpoint->releaseRecv(handle);
+        //still dry after the drain in the middle of a burst: the device is about to underflow,
+        //report the risk to the client, raise the target, and refill before resuming
+        if (dry and count == 0)
+        {
+            numUnderruns++;
+            packetsSinceUnderrun = 0;
+            target = std::min(maxTarget, target + target/2);
+            endpoint->writeStatus(SOAPY_SDR_UNDERFLOW, chanMask, 0, 0);
+            filling = true;
+        }
+
+        //start writing at the target fill, the end of a short burst,
+        //when the client stopped sending before reaching the target,
+        //or when short packets filled the ring before the target
+        if (filling and count != 0)
+        {
+            const bool timedOut = (std::chrono::high_resolution_clock::now() - fillStart) >= fillTimeout;
+            if (queuedElems >= target or queuedBurstEnds != 0 or timedOut or count == ring.size()) filling = false;
+        }
+        if (filling or count == 0) continue;
+
+        //write the oldest packet to the device
+        auto &packet = ring[head];
+        for (size_t i = 0; i < numChans; i++) buffs[i] = packet.buff.data()+(i*buffSize*elemSize);
+        this->writeDevice(buffs, packet.numElems, packet.flags, packet.timeNs);
+        head = (head+1)%ring.size();
+        count--;
+        queuedElems -= packet.numElems;
+        inBurst = (packet.flags & SOAPY_SDR_END_BURST) == 0;
+        if (not inBurst)
+        {
+            queuedBurstEnds--;
+            filling = true;
+        }
+
+        //lower the target again after a long run without running dry
+        if (++packetsSinceUnderrun >= SOAPY_REMOTE_JITTER_ADAPT_PACKETS)
+        {
+            packetsSinceUnderrun = 0;
+            target = std::max(minTarget, target - target/10);
+        }
+    }
+
+    if (numUnderruns != 0) SoapySDR::logf(SOAPY_SDR_INFO,
+        "Server-side jitter buffer ran dry %d times, final target %d elements", int(numUnderruns), int(target));
+}
+
+void ServerStreamData::requestPlayback(const std::shared_ptr<const ServerWaveform> &waveform, const size_t repeat, const int flags, const long long timeNs)
+{
+    std::lock_guard<std::mutex> lock(playMutex);
+    playWaveform = waveform;
+    playRepeat = repeat;
+    playFlags = flags;
+    playTimeNs = timeNs;
+}
+
+void ServerStreamData::stopPlayback(void)
+{
+    std::lock_guard<std::mutex> lock(playMutex);
+    playWaveform.reset();
+    playStop = true;
+}
+
+bool ServerStreamData::playbackInterrupted(void)
+{
+    std::lock_guard<std::mutex> lock(playMutex);
+    return playStop or playWaveform;
+}
+
+bool ServerStreamData::playbackWork(void)
+{
+    //take the pending playback request
+    std::shared_ptr<const ServerWaveform> waveform;
+    size_t repeat = 0;
+    int flags = 0;
+    long long timeNs = 0;
+    {
+        std::lock_guard<std::mutex> lock(playMutex);
+        if (not playWaveform) return false;
+        waveform.swap(playWaveform);
+        repeat = playRepeat;
+        flags = playFlags & SOAPY_SDR_HAS_TIME;
+        timeNs = playTimeNs;
+        playStop = false;
+    }
+
+    const auto elemSize = endpoint->getElemSize();
+    std::vector<const void *> buffs(waveform->numChans);
+
+    //one continuous burst for all repetitions, a stop request or a new
+    //playback request ends the burst after the current repetition
+    for (size_t rep = 0; (repeat == 0 or rep < repeat) and not done; rep++)
+    {
+        size_t elemsLeft = waveform->numElems;
+        while (elemsLeft != 0 and not done)
+        {
+            const bool last = (rep+1 == repeat) or this->playbackInterrupted();
+            if (last) flags |= SOAPY_SDR_END_BURST;
+            const size_t offset = waveform->numElems - elemsLeft;
+            for (size_t i = 0; i < buffs.size(); i++)
+            {
+                buffs[i] = waveform->samples.data() + ((i*waveform->numElems + offset)*elemSize);
+            }
+
+            const int ret = device->writeStream(stream, buffs.data(), elemsLeft, flags, timeNs, SOAPY_REMOTE_DEVICE_TIMEOUT_US);
+            if (ret == SOAPY_SDR_TIMEOUT) continue;
+            if (ret < 0)
+            {
+                endpoint->writeStatus(ret, chanMask, flags, timeNs);
+                return true; //abandon the playback after error
+            }
+            elemsLeft -= std::min<size_t>(elemsLeft, ret);
+            flags &= ~(SOAPY_SDR_HAS_TIME); //clear time for subsequent writes
+        }
+        if ((flags & SOAPY_SDR_END_BURST) != 0) break;
     }
+    return true;
 }
 
 void ServerStreamData::sendEndpointWork(void)
@@ -157,6 +443,7 @@ void ServerStreamData::sendEndpointWork(void)
     long long timeNs = 0;
     const auto elemSize = endpoint->getElemSize();
     std::vector<void *> buffs(endpoint->getNumChans());
+    std::vector<void *> baseBuffs(endpoint->getNumChans());
     const size_t mtuElems = device->getStreamMTU(stream);
 
     //loop forever until signaled done
@@ -173,6 +460,7 @@ void ServerStreamData::sendEndpointWork(void)
             SoapySDR::logf(SOAPY_SDR_ERROR, "Server-side send endpoint: %s; worker quitting...", streamSock->lastErrorMsg());
             return;
         }
+        std::copy(buffs.begin(), buffs.end(), baseBuffs.begin());
 
         //Read only up to MTU size with a timeout for minimal waiting.
         //In the next section we will continue the read with non-blocking.
@@ -182,7 +470,7 @@ void ServerStreamData::sendEndpointWork(void)
         {
             flags = 0; //flags is an in/out parameter and must be cleared for consistency
             const size_t numElems = std::min(mtuElems, elemsLeft);
-            ret = device->readStream(stream, buffs.data(), numElems, flags, timeNs, SOAPY_REMOTE_SOCKET_TIMEOUT_US);
+            ret = device->readStream(stream, buffs.data(), numElems, flags, timeNs, SOAPY_REMOTE_DEVICE_TIMEOUT_US);
             if (ret == SOAPY_SDR_TIMEOUT) continue;
             if (ret < 0)
             {
@@ -216,12 +504,109 @@ void ServerStreamData::sendEndpointWork(void)
             flags |= (flags1 & trailingFlags);
         }
 
+        //record the forwarded samples into the recorders
+        if (ret >= 0 and elemsRead != 0)
+        {
+            std::lock_guard<std::mutex> lock(recordMutex);
+            for (const auto &recorder : recorders) recorder.second->append(baseBuffs[recorder.first], elemsRead);
+        }
+
         //release the buffer with flags and time from the first read
         //if any read call returned an error, forward the error instead
         endpoint->releaseSend(handle, (ret < 0)?ret:elemsRead, flags, timeNs);
     }
 }
 
+void ServerStreamData::historyEndpointWork(void)
+{
+    setThreadPrioWithLogging(priority);
+    assert(endpoint != nullptr);
+    assert(endpoint->getNumChans() != 0);
+    assert(history);
+
+    //setup worker data structures
+    int ret = 0;
+    size_t handle = 0;
+    int error = 0;
+    unsigned long long index = history->newest();
+    std::vector<void *> buffs(endpoint->getNumChans());
+
+    //loop forever until signaled done
+    //1) wait for the reader to append the next samples (or an error)
+    //2) acquire the send buffer and copy out of the history
+    //3) release the buffer back to the endpoint (sends)
+    while (not done)
+    {
+        if (error == 0) error = readerError.exchange(0);
+        if (error == 0 and not history->waitAvailable(index, SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
+        if (not endpoint->waitSend(SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
+        ret = endpoint->acquireSend(handle, buffs.data());
+        if (ret < 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "Server-side history endpoint: %s; worker quitting...", streamSock->lastErrorMsg());
+            return;
+        }
+
+        int flags = 0;
+        long long timeNs = 0;
+        if (error != 0) ret = error; //forward the device error
+        else
+        {
+            ret = history->read(index, buffs.data(), size_t(ret));
+            if (ret > 0 and history->hasTime())
+            {
+                flags |= SOAPY_SDR_HAS_TIME;
+                timeNs = history->timeAt(index);
+            }
+            if (ret > 0) index += ret;
+
+            //the client fell behind the ring, resume with the newest samples
+            if (ret == SOAPY_SDR_OVERFLOW) index = history->newest();
+        }
+        error = 0;
+
+        endpoint->releaseSend(handle, ret, flags, timeNs);
+    }
+}
+
+void ServerStreamData::readerWork(void)
+{
+    setThreadPrioWithLogging(priority);
+    assert(not channels.empty());
+
+    //setup worker data structures
+    int flags = 0;
+    long long timeNs = 0;
+    const size_t elemSize = SoapySDR::formatToSize(format);
+    const size_t mtuElems = device->getStreamMTU(stream);
+    std::vector<char> mem(channels.size()*mtuElems*elemSize);
+    std::vector<void *> buffs(channels.size());
+    for (size_t i = 0; i < buffs.size(); i++) buffs[i] = mem.data() + (i*mtuElems*elemSize);
+
+    //loop forever until signaled done
+    //1) read from the device stream into the local buffers
+    //2) append the samples to the history and the recorders
+    //there is no endpoint, so a slow client never stalls the reader
+    while (not done)
+    {
+        flags = 0; //flags is an in/out parameter and must be cleared for consistency
+        const int ret = device->readStream(stream, buffs.data(), mtuElems, flags, timeNs, SOAPY_REMOTE_DEVICE_TIMEOUT_US);
+        if (ret == SOAPY_SDR_TIMEOUT) continue;
+        if (ret < 0)
+        {
+            //the history endpoint forwards the error to the client,
+            //the stream is likely not active after other errors
+            readerError = ret;
+            if (ret != SOAPY_SDR_OVERFLOW) std::this_thread::sleep_for(std::chrono::microseconds(SOAPY_REMOTE_DEVICE_TIMEOUT_US));
+            continue;
+        }
+
+        if (history) history->append(buffs.data(), size_t(ret), flags, timeNs);
+        std::lock_guard<std::mutex> lock(recordMutex);
+        for (const auto &recorder : recorders) recorder.second->append(buffs[recorder.first], size_t(ret));
+    }
+}
+
 void ServerStreamData::statEndpointWork(void)
 {
     assert(endpoint != nullptr);
@@ -233,7 +618,7 @@ void ServerStreamData::statEndpointWork(void)
 
     while (not done)
     {
-        ret = device->readStreamStatus(stream, chanMask, flags, timeNs, SOAPY_REMOTE_SOCKET_TIMEOUT_US);
+        ret = device->readStreamStatus(stream, chanMask, flags, timeNs, SOAPY_REMOTE_DEVICE_TIMEOUT_US);
         if (ret == SOAPY_SDR_TIMEOUT) continue;
         endpoint->writeStatus(ret, chanMask, flags, timeNs);
 
@@ -242,3 +627,118 @@ void ServerStreamData::statEndpointWork(void)
         if (ret == SOAPY_SDR_NOT_SUPPORTED) return;
     }
 }
+
+int ServerStreamData::requestReplay(const int flags, const long long timeNs, const size_t numElems)
+{
+    if (not history) return SOAPY_SDR_NOT_SUPPORTED;
+
+    //locate the start of the window, default to the oldest sample
+    unsigned long long index = history->oldest();
+    if ((flags & SOAPY_SDR_HAS_TIME) != 0)
+    {
+        const int ret = history->find(timeNs, index);
+        if (ret != 0) return ret;
+    }
+
+    //zero elements means everything available up to now
+    const unsigned long long end = (numElems == 0)?history->newest():(index + numElems);
+    if (end <= index) return SOAPY_SDR_TIME_ERROR;
+
+    std::lock_guard<std::mutex> lock(replayMutex);
+    replayIndex = index;
+    replayEnd = end;
+    replayActive = true;
+    replayCond.notify_one();
+    return 0;
+}
+
+int ServerStreamData::cancelReplay(void)
+{
+    std::lock_guard<std::mutex> lock(replayMutex);
+    replayActive = false;
+    return 0;
+}
+
+void ServerStreamData::addRecorder(const size_t index, const std::shared_ptr<SoapyStreamRecorder> &recorder)
+{
+    std::lock_guard<std::mutex> lock(recordMutex);
+    recorders[index] = recorder;
+}
+
+bool ServerStreamData::removeRecorder(const std::shared_ptr<SoapyStreamRecorder> &recorder)
+{
+    std::lock_guard<std::mutex> lock(recordMutex);
+    for (auto it = recorders.begin(); it != recorders.end(); ++it)
+    {
+        if (it->second != recorder) continue;
+        recorders.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void ServerStreamData::replayEndpointWork(void)
+{
+    setThreadPrioWithLogging(priority);
+    assert(endpoint != nullptr);
+    assert(endpoint->getNumChans() != 0);
+
+    //setup worker data structures
+    int ret = 0;
+    size_t handle = 0;
+    std::vector<void *> buffs(endpoint->getNumChans());
+
+    //loop forever until signaled done
+    //1) wait for a replay request from the client
+    //2) wait for the next samples to be available in the history
+    //3) acquire the send buffer and copy out of the history
+    //4) release the buffer back to the endpoint (sends)
+    while (not done)
+    {
+        unsigned long long index = 0, end = 0;
+        {
+            std::unique_lock<std::mutex> lock(replayMutex);
+            if (not replayActive)
+            {
+                replayCond.wait_for(lock, std::chrono::microseconds(SOAPY_REMOTE_SOCKET_TIMEOUT_US),
+                    [this]{return replayActive or done;});
+                continue;
+            }
+            index = replayIndex;
+            end = replayEnd;
+        }
+
+        if (not history->waitAvailable(index, SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
+        if (not endpoint->waitSend(SOAPY_REMOTE_SOCKET_TIMEOUT_US)) continue;
+        ret = endpoint->acquireSend(handle, buffs.data());
+        if (ret < 0)
+        {
+            SoapySDR::logf(SOAPY_SDR_ERROR, "Server-side replay endpoint: %s; worker quitting...", streamSock->lastErrorMsg());
+            return;
+        }
+
+        //every packet is timestamped, overwritten samples report overflow
+        const size_t numElems = size_t(std::min<unsigned long long>(size_t(ret), end - index));
+        ret = history->read(index, buffs.data(), numElems);
+        int flags = 0;
+        long long timeNs = 0;
+        if (ret > 0)
+        {
+            flags |= SOAPY_SDR_HAS_TIME;
+            timeNs = history->timeAt(index);
+        }
+
+        //advance the window unless it was replaced or cancelled meanwhile
+        {
+            std::lock_guard<std::mutex> lock(replayMutex);
+            if (replayActive and replayIndex == index)
+            {
+                if (ret > 0) replayIndex += ret;
+                if (ret < 0 or replayIndex >= replayEnd) replayActive = false;
+                if (ret > 0 and not replayActive) flags |= SOAPY_SDR_END_BURST;
+            }
+        }
+
+        endpoint->releaseSend(handle, ret, flags, timeNs);
+    }
+}
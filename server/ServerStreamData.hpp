@@ -4,11 +4,19 @@
 #pragma once
 #include "SoapyRPCSocket.hpp"
 #include "ThreadPrioHelper.hpp"
-#include <csignal> //sig_atomic_t
 #include <string>
 #include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <map>
 
 class SoapyStreamEndpoint;
+class SoapySocketPool;
+class SoapyStreamHistory;
+class SoapyStreamRecorder;
 
 namespace SoapySDR
 {
@@ -16,6 +24,18 @@ namespace SoapySDR
     class Stream;
 }
 
+/*!
+ * A named waveform uploaded by the client for playback.
+ * The samples are stored one channel after another.
+ */
+struct ServerWaveform
+{
+    std::string format;
+    size_t numChans;
+    size_t numElems;
+    std::string samples;
+};
+
 /*!
  * Server-side stream data for client handler.
  * This class manages a recv/send endpoint,
@@ -29,10 +49,17 @@ public:
 
     SoapySDR::Device *device;
     SoapySDR::Stream *stream;
+    int direction;
     std::string format;
+    std::vector<size_t> channels;
     size_t chanMask;
     double priority;
 
+    //transmit jitter buffer target in elements (0 disables)
+    //and the sample rate used to convert it to a fill timeout
+    size_t jitterElems;
+    double jitterRate;
+
     //this ID identifies the stream to the remote host
     int streamId;
 
@@ -42,25 +69,91 @@ public:
     //datagram socket for status endpoint
     SoapyRPCSocket *statusSock;
 
+    //additional tcp connections for a striped stream
+    std::vector<SoapyRPCSocket *> stripeSocks;
+
+    //the pool that datagram sockets are returned to (when set)
+    SoapySocketPool *socketPool;
+
+    //the status goes over the status channel (the status socket is unused)
+    bool useStatusChannel;
+
     //remote side of the stream endpoint
     SoapyStreamEndpoint *endpoint;
 
+    //optional history of a receive stream,
+    //shared with replay streams on the same channels
+    std::shared_ptr<SoapyStreamHistory> history;
+
+    //replay streams read from the history rather than the device
+    bool replay;
+
+    //record-only streams read the device for the recorders without an endpoint,
+    //streams with a history forward the samples that the reader appends
+    bool recordOnly;
+
+    //request a window of the history for a replay stream
+    int requestReplay(const int flags, const long long timeNs, const size_t numElems);
+    int cancelReplay(void);
+
+    //tee a channel of a receive stream to a recorder (index into channels)
+    void addRecorder(const size_t index, const std::shared_ptr<SoapyStreamRecorder> &recorder);
+    bool removeRecorder(const std::shared_ptr<SoapyStreamRecorder> &recorder);
+
+    //play a cached waveform on a transmit stream (repeat 0 loops)
+    void requestPlayback(const std::shared_ptr<const ServerWaveform> &waveform, const size_t repeat, const int flags, const long long timeNs);
+    void stopPlayback(void);
+
     //hooks to start/stop work
     void startSendThread(void);
     void startRecvThread(void);
     void startStatThread(void);
+    void startReplayThread(void);
+    void startReaderThread(void);
+    void signalStop(void);
     void stopThreads(void);
 
     //worker implementations
     void recvEndpointWork(void);
+    void recvJitterEndpointWork(void);
     void sendEndpointWork(void);
     void statEndpointWork(void);
+    void replayEndpointWork(void);
+    void historyEndpointWork(void);
+    void readerWork(void);
 
 private:
+    void writeDevice(std::vector<const void *> &buffs, size_t elemsLeft, int flags, const long long timeNs);
+    bool playbackWork(void);
+    bool playbackInterrupted(void);
+
     //worker thread for this stream
     std::thread *streamThread;
     std::thread *statusThread;
+    std::thread *readerThread;
 
     //signal done to the thread
-    sig_atomic_t done;
+    std::atomic<bool> done;
+
+    //the last device error from the reader thread (0 for none)
+    std::atomic<int> readerError;
+
+    //replay window state
+    std::mutex replayMutex;
+    std::condition_variable replayCond;
+    bool replayActive;
+    unsigned long long replayIndex;
+    unsigned long long replayEnd;
+
+    //active recorders by channel index
+    std::mutex recordMutex;
+    std::map<size_t, std::shared_ptr<SoapyStreamRecorder>> recorders;
+
+    //pending waveform playback request
+    std::mutex playMutex;
+    std::shared_ptr<const ServerWaveform> playWaveform;
+    size_t playRepeat;
+    int playFlags;
+    long long playTimeNs;
+    bool playStop;
 };
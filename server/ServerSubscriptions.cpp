@@ -0,0 +1,94 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ServerSubscriptions.hpp"
+#include "SoapyRemoteDefs.hpp"
+#include "SoapyRPCPacker.hpp"
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm> //max
+
+ServerSubscriptions::ServerSubscriptions(SoapyRPCSocket &sock, std::mutex &sendMutex, SoapySDR::Device *device, const unsigned int remoteRPCVersion):
+    _sock(sock),
+    _sendMutex(sendMutex),
+    _device(device),
+    _remoteRPCVersion(remoteRPCVersion)
+{
+    return;
+}
+
+void ServerSubscriptions::subscribe(const std::string &what, const int direction, const int channel, const long long periodUs)
+{
+    const auto key = std::to_string(direction) + ":" + std::to_string(channel) + ":" + what;
+    if (periodUs <= 0)
+    {
+        _subscriptions.erase(key);
+        return;
+    }
+
+    //the first value is pushed right away
+    auto &sub = _subscriptions[key];
+    sub.what = what;
+    sub.direction = direction;
+    sub.channel = channel;
+    sub.period = std::chrono::microseconds(std::max<long long>(periodUs, SOAPY_REMOTE_SUBSCRIBE_MIN_PERIOD_US));
+    sub.due = std::chrono::steady_clock::now();
+}
+
+void ServerSubscriptions::pushDue(void)
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = _subscriptions.begin(); it != _subscriptions.end();)
+    {
+        if (now < it->second.due)
+        {
+            ++it;
+            continue;
+        }
+
+        //late pushes are not made up, the next one is a period from now
+        it->second.due = std::max(it->second.due + it->second.period, now);
+
+        //a failing subscription is dropped rather than logged every period
+        if (this->push(it->second)) ++it;
+        else it = _subscriptions.erase(it);
+    }
+}
+
+long ServerSubscriptions::waitUs(void) const
+{
+    if (_subscriptions.empty()) return -1;
+    auto next = _subscriptions.begin()->second.due;
+    for (const auto &pair : _subscriptions) next = std::min(next, pair.second.due);
+    const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(next - std::chrono::steady_clock::now());
+    return long(std::max<long long>(wait.count(), 0));
+}
+
+bool ServerSubscriptions::push(const Subscription &sub)
+{
+    try
+    {
+        //the hardware time is only read for the time subscription
+        std::string value;
+        long long timeNs = 0;
+        if (sub.what == SOAPY_REMOTE_KWARG_SUBSCRIBE_TIME) timeNs = _device->getHardwareTime();
+        else if (sub.channel < 0) value = _device->readSensor(sub.what);
+        else value = _device->readSensor(sub.direction, size_t(sub.channel), sub.what);
+
+        std::lock_guard<std::mutex> sendLock(_sendMutex);
+        SoapyRPCPacker packer(_sock, _remoteRPCVersion);
+        packer & SOAPY_REMOTE_PUSH_SENSOR;
+        packer & sub.what;
+        packer & char(sub.direction);
+        packer & sub.channel;
+        packer & value;
+        packer & timeNs;
+        packer();
+    }
+    catch (const std::exception &ex)
+    {
+        SoapySDR::logf(SOAPY_SDR_ERROR, "ServerSubscriptions push %s FAIL: %s", sub.what.c_str(), ex.what());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <map>
+
+class SoapyRPCSocket;
+
+namespace SoapySDR
+{
+    class Device;
+}
+
+/*!
+ * Push subscribed sensor values and the hardware time to the client.
+ * The client handler pushes the due subscriptions between requests,
+ * so the device is only ever called from the client handler thread.
+ * The send mutex keeps pushes whole with heartbeats and log messages.
+ */
+class ServerSubscriptions
+{
+public:
+    ServerSubscriptions(SoapyRPCSocket &sock, std::mutex &sendMutex, SoapySDR::Device *device, const unsigned int remoteRPCVersion);
+
+    //! Add, change, or remove (period 0) a subscription, channel -1 for device sensors
+    void subscribe(const std::string &what, const int direction, const int channel, const long long periodUs);
+
+    //! Read and push every subscription that is due
+    void pushDue(void);
+
+    //! Microseconds until the next subscription is due, -1 when there are none
+    long waitUs(void) const;
+
+private:
+    struct Subscription
+    {
+        std::string what;
+        int direction;
+        int channel;
+        std::chrono::microseconds period;
+        std::chrono::steady_clock::time_point due;
+    };
+
+    //read and push one subscription, return false when it failed
+    bool push(const Subscription &sub);
+
+    SoapyRPCSocket &_sock;
+    std::mutex &_sendMutex;
+    SoapySDR::Device *_device;
+    const unsigned int _remoteRPCVersion;
+    std::map<std::string, Subscription> _subscriptions;
+};
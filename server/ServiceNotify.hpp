@@ -0,0 +1,13 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <string>
+
+/*!
+ * Tell the service manager that the server is ready for clients.
+ * On Linux this sends READY=1 to $NOTIFY_SOCKET (systemd Type=notify),
+ * and does nothing when the server was not started by systemd.
+ * \return an error message or empty on success
+ */
+std::string notifyServiceReady(void);
@@ -0,0 +1,35 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ServiceNotify.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstdlib> //getenv
+#include <cstring> //memset, memcpy, strerror
+#include <cstddef> //offsetof
+#include <cerrno> //errno
+
+std::string notifyServiceReady(void)
+{
+    const char *path = std::getenv("NOTIFY_SOCKET");
+    if (path == nullptr or path[0] == '\0') return "";
+
+    //the path is a file system socket or an abstract socket starting with @
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    const size_t pathLen = std::strlen(path);
+    if (pathLen >= sizeof(addr.sun_path)) return "NOTIFY_SOCKET path too long";
+    std::memcpy(addr.sun_path, path, pathLen);
+    if (addr.sun_path[0] == '@') addr.sun_path[0] = '\0';
+    const socklen_t addrLen = socklen_t(offsetof(struct sockaddr_un, sun_path) + pathLen);
+
+    const int sock = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) return strerror(errno);
+    const std::string msg("READY=1");
+    const ssize_t ret = sendto(sock, msg.data(), msg.size(), MSG_NOSIGNAL, (struct sockaddr *)&addr, addrLen);
+    const std::string err = (ret < 0)?strerror(errno):"";
+    close(sock);
+    return err;
+}
@@ -0,0 +1,9 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "ServiceNotify.hpp"
+
+std::string notifyServiceReady(void)
+{
+    return "";
+}
@@ -8,9 +8,17 @@
 #include "SoapyRPCSocket.hpp"
 #include "SoapySSDPEndpoint.hpp"
 #include "SoapyMDNSEndpoint.hpp"
+#include "EnumerateCache.hpp"
+#include "HotplugMonitor.hpp"
+#include "DeviceFactory.hpp"
+#include "ServiceNotify.hpp"
+#include <SoapySDR/Modules.hpp>
 #include <cstdlib>
 #include <cstddef>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
 #include <getopt.h>
 #include <csignal>
 
@@ -23,6 +31,12 @@ static int printHelp(void)
     std::cout << "  Options summary:" << std::endl;
     std::cout << "    --help \t\t\t\t Print this help message" << std::endl;
     std::cout << "    --bind \t\t\t\t Bind and serve forever" << std::endl;
+    std::cout << "    --enumerate-ttl=SECONDS \t\t Cache enumerate results (0 disables)" << std::endl;
+    std::cout << "    --global-lock=DRIVER[,DRIVER] \t Open these drivers one device at a time" << std::endl;
+    std::cout << "    --warm-pool=SECONDS \t\t Keep released devices open for reuse" << std::endl;
+    std::cout << "    --preload \t\t\t\t Load modules and enumerate at startup" << std::endl;
+    std::cout << "    --open=ARGS \t\t\t Open a device at startup (repeatable)" << std::endl;
+    std::cout << "    --config=FILE \t\t\t Read options from a file, one per line" << std::endl;
     std::cout << std::endl;
     return EXIT_SUCCESS;
 }
@@ -37,10 +51,39 @@ void sigIntHandler(const int)
     serverDone = true;
 }
 
+/***********************************************************************
+ * Warm up before accepting clients
+ **********************************************************************/
+static bool warmupServer(const bool preload, const std::vector<std::string> &openArgs)
+{
+    if (preload)
+    {
+        std::cout << "Loading modules... " << std::endl;
+        SoapySDR::loadModules();
+        const auto results = ServerEnumerateCache::enumerate(SoapySDR::Kwargs());
+        std::cout << "Found " << results.size() << " devices" << std::endl;
+    }
+
+    for (const auto &args : openArgs)
+    {
+        std::cout << "Opening device " << args << "... " << std::endl;
+        try
+        {
+            ServerDeviceFactory::preopen(SoapySDR::KwargsFromString(args));
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << "Device open FAIL: " << ex.what() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 /***********************************************************************
  * Launch the server
  **********************************************************************/
-static int runServer(void)
+static int runServer(const std::string &bindURL, const bool preload, const std::vector<std::string> &openArgs)
 {
     SoapySocketSession sess;
     const bool isIPv6Supported = not SoapyRPCSocket(SoapyURL("tcp", "::", "0").toString()).null();
@@ -48,8 +91,7 @@ static int runServer(void)
     const int ipVerServices = isIPv6Supported?SOAPY_REMOTE_IPVER_UNSPEC:SOAPY_REMOTE_IPVER_INET;
 
     //extract url from user input or generate automatically
-    const bool optargHasURL = (optarg != NULL and not std::string(optarg).empty());
-    auto url = (optargHasURL)? SoapyURL(optarg) : SoapyURL("tcp", defaultBindNode, "");
+    auto url = (not bindURL.empty())? SoapyURL(bindURL) : SoapyURL("tcp", defaultBindNode, "");
 
     //default url parameters when not specified
     if (url.getScheme().empty()) url.setScheme("tcp");
@@ -60,6 +102,12 @@ static int runServer(void)
     std::cout << "Server version: " << SoapyInfo::getServerVersion() << std::endl;
     std::cout << "Server UUID: " << serverUUID << std::endl;
 
+    if (not warmupServer(preload, openArgs))
+    {
+        ServerDeviceFactory::reapWarmPool(true);
+        return EXIT_FAILURE;
+    }
+
     std::cout << "Launching the server... " << url.toString() << std::endl;
     SoapyRPCSocket s;
     if (s.bind(url.toString()) != 0)
@@ -80,12 +128,29 @@ static int runServer(void)
     dnssdPublish->printInfo();
     dnssdPublish->registerService(serverUUID, url.getService(), ipVerServices);
 
+    //device changes invalidate the enumerate cache,
+    //and the cache generation is advertised as the SSDP config ID
+    SoapyHotplugMonitor hotplugMonitor(&ServerEnumerateCache::invalidate);
+    unsigned cacheGeneration = ServerEnumerateCache::generation();
+    ssdpEndpoint->setConfigId(cacheGeneration+1);
+
+    //expired warm devices close off the accept loop
+    auto warmPoolReaper = new ServerWarmPoolReaper();
+
+    const auto notifyErr = notifyServiceReady();
+    if (not notifyErr.empty()) std::cerr << "Service manager notify FAIL: " << notifyErr << std::endl;
+
     std::cout << "Press Ctrl+C to stop the server" << std::endl;
     signal(SIGINT, sigIntHandler);
     bool exitFailure = false;
     while (not serverDone and not exitFailure)
     {
         serverListener->handleOnce();
+        if (cacheGeneration != ServerEnumerateCache::generation())
+        {
+            cacheGeneration = ServerEnumerateCache::generation();
+            ssdpEndpoint->setConfigId(cacheGeneration+1);
+        }
         if (not s.status())
         {
             std::cerr << "Server socket failure: " << s.lastErrorMsg() << std::endl;
@@ -104,12 +169,54 @@ static int runServer(void)
 
     std::cout << "Shutdown client handler threads" << std::endl;
     delete serverListener;
+    delete warmPoolReaper;
+    ServerDeviceFactory::reapWarmPool(true);
     s.close();
 
     std::cout << "Cleanup complete, exiting" << std::endl;
     return exitFailure?EXIT_FAILURE:EXIT_SUCCESS;
 }
 
+/***********************************************************************
+ * Replace --config=FILE with the options in the file:
+ * one option per line without the dashes, # starts a comment
+ **********************************************************************/
+static bool expandConfigFiles(int argc, char *argv[], std::vector<std::string> &args)
+{
+    for (int i = 0; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        std::string path;
+        if (arg == "--config" or arg == "-config")
+        {
+            if (i+1 < argc) path = argv[++i];
+        }
+        else if (arg.find("--config=") == 0) path = arg.substr(9);
+        else if (arg.find("-config=") == 0) path = arg.substr(8);
+        else
+        {
+            args.push_back(arg);
+            continue;
+        }
+
+        std::ifstream file(path.c_str());
+        if (not file.is_open())
+        {
+            std::cerr << "Cannot open config file: " << path << std::endl;
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line))
+        {
+            line = line.substr(0, line.find('#'));
+            line.erase(0, line.find_first_not_of(" \t\r"));
+            line.erase(line.find_last_not_of(" \t\r")+1);
+            if (not line.empty()) args.push_back("--"+line);
+        }
+    }
+    return true;
+}
+
 /***********************************************************************
  * Parse and dispatch options
  **********************************************************************/
@@ -126,19 +233,60 @@ int main(int argc, char *argv[])
     static struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
         {"bind", optional_argument, 0, 'b'},
+        {"enumerate-ttl", required_argument, 0, 'e'},
+        {"global-lock", required_argument, 0, 'g'},
+        {"warm-pool", required_argument, 0, 'w'},
+        {"preload", no_argument, 0, 'p'},
+        {"open", required_argument, 0, 'o'},
         {0, 0, 0,  0}
     };
+    std::vector<std::string> args;
+    if (not expandConfigFiles(argc, argv, args)) return EXIT_FAILURE;
+    std::vector<char *> argvExpanded;
+    for (auto &arg : args) argvExpanded.push_back(&arg[0]);
+    argvExpanded.push_back(nullptr);
+
     int long_index = 0;
     int option = 0;
-    while ((option = getopt_long_only(argc, argv, "", long_options, &long_index)) != -1)
+    bool bind = false;
+    bool preload = false;
+    std::string bindURL;
+    std::vector<std::string> openArgs;
+    while ((option = getopt_long_only(int(args.size()), argvExpanded.data(), "", long_options, &long_index)) != -1)
     {
         switch (option)
         {
         case 'h': return printHelp();
-        case 'b': return runServer();
+        case 'b':
+            bind = true;
+            if (optarg != NULL) bindURL = optarg;
+            break;
+        case 'e':
+            ServerEnumerateCache::setTTL((long long)(std::atof(optarg)*1e6));
+            break;
+        case 'g':
+        {
+            std::vector<std::string> drivers;
+            std::stringstream ss(optarg);
+            std::string driver;
+            while (std::getline(ss, driver, ',')) if (not driver.empty()) drivers.push_back(driver);
+            ServerDeviceFactory::setGlobalLockDrivers(drivers);
+        } break;
+        case 'w':
+            ServerDeviceFactory::setWarmPoolTime((long long)(std::atof(optarg)*1e6));
+            break;
+        case 'p':
+            preload = true;
+            break;
+        case 'o':
+            openArgs.push_back(optarg);
+            break;
+        default: return printHelp();
         }
     }
 
+    if (bind) return runServer(bindURL, preload, openArgs);
+
     //unknown or unspecified options, do help...
     return printHelp();
 }
@@ -0,0 +1,211 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "StreamHistory.hpp"
+#include <SoapySDR/Constants.h>
+#include <SoapySDR/Errors.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm> //min, upper_bound
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <cstring> //memcpy
+#include <cstdlib> //malloc
+#include <cmath> //llround
+
+#ifndef _WIN32
+#include <sys/mman.h> //mmap
+#endif
+
+//! Round hugepage allocations to the common 2 MiB page size
+static const size_t HUGE_PAGE_SIZE = 2*1024*1024;
+
+SoapyStreamHistory::SoapyStreamHistory(const size_t numChans, const size_t elemSize, const size_t numElems, const double sampleRate):
+    _numChans(numChans),
+    _elemSize(elemSize),
+    _capacity(numElems),
+    _sampleRate(sampleRate),
+    _mem(nullptr),
+    _memSize(numChans*numElems*elemSize),
+    _mapped(false),
+    _writeCount(0)
+{
+    if (_memSize == 0 or _sampleRate <= 0.0) throw std::runtime_error(
+        "SoapyStreamHistory() -- history requires a non-zero size and sample rate");
+
+    const char *memType = "heap";
+
+    #ifndef _WIN32
+    int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #ifdef MAP_POPULATE
+    mapFlags |= MAP_POPULATE; //fault in the pages now rather than in the stream thread
+    #endif
+
+    //try for hugepages first to reduce TLB pressure on very large rings
+    #ifdef MAP_HUGETLB
+    const size_t hugeSize = ((_memSize+HUGE_PAGE_SIZE-1)/HUGE_PAGE_SIZE)*HUGE_PAGE_SIZE;
+    void *hugeMem = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, mapFlags | MAP_HUGETLB, -1, 0);
+    if (hugeMem != MAP_FAILED)
+    {
+        _mem = (char *)hugeMem;
+        _memSize = hugeSize;
+        _mapped = true;
+        memType = "hugepages";
+    }
+    #endif //MAP_HUGETLB
+
+    if (_mem == nullptr)
+    {
+        void *mem = mmap(nullptr, _memSize, PROT_READ | PROT_WRITE, mapFlags, -1, 0);
+        if (mem != MAP_FAILED)
+        {
+            _mem = (char *)mem;
+            _mapped = true;
+            memType = "mmap";
+        }
+    }
+    #endif //_WIN32
+
+    if (_mem == nullptr)
+    {
+        _mem = (char *)std::malloc(_memSize);
+        if (_mem == nullptr) throw std::runtime_error(
+            "SoapyStreamHistory() -- failed to allocate "+std::to_string(_memSize/(1024*1024))+" MiB");
+        std::memset(_mem, 0, _memSize); //touch all pages up-front
+    }
+
+    SoapySDR::logf(SOAPY_SDR_INFO, "Stream history: %g seconds, %d elements, %d MiB (%s)",
+        _capacity/_sampleRate, int(_capacity), int(_memSize/(1024*1024)), memType);
+}
+
+SoapyStreamHistory::~SoapyStreamHistory(void)
+{
+    #ifndef _WIN32
+    if (_mapped) munmap(_mem, _memSize);
+    #endif //_WIN32
+    if (not _mapped) std::free(_mem);
+}
+
+void SoapyStreamHistory::append(const void * const *buffs, const size_t numElems, const int flags, const long long timeNs)
+{
+    if (numElems == 0) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    //record a time anchor for this block,
+    //a time that goes backwards invalidates the older anchors
+    if ((flags & SOAPY_SDR_HAS_TIME) != 0)
+    {
+        if (not _anchors.empty() and timeNs < _anchors.back().timeNs) _anchors.clear();
+        TimeAnchor anchor;
+        anchor.index = _writeCount;
+        anchor.timeNs = timeNs;
+        _anchors.push_back(anchor);
+    }
+
+    //blocks larger than the ring only keep the trailing samples
+    size_t skip = 0;
+    if (numElems > _capacity) skip = numElems - _capacity;
+
+    const size_t offset = size_t((_writeCount+skip) % _capacity);
+    const size_t count = numElems - skip;
+    const size_t first = std::min(count, _capacity - offset);
+    for (size_t i = 0; i < _numChans; i++)
+    {
+        char *base = _mem + (i*_capacity*_elemSize);
+        const char *in = ((const char *)buffs[i]) + (skip*_elemSize);
+        std::memcpy(base + offset*_elemSize, in, first*_elemSize);
+        std::memcpy(base, in + first*_elemSize, (count-first)*_elemSize);
+    }
+    _writeCount += numElems;
+
+    //drop anchors that left the ring, but keep one for the oldest samples
+    const auto oldestIndex = (_writeCount > _capacity)?(_writeCount - _capacity):0;
+    while (_anchors.size() > 1 and _anchors[1].index <= oldestIndex) _anchors.pop_front();
+
+    _cond.notify_all();
+}
+
+long long SoapyStreamHistory::anchorTime(const TimeAnchor &anchor, const unsigned long long index) const
+{
+    const double deltaElems = double((long long)(index - anchor.index));
+    return anchor.timeNs + std::llround(deltaElems*1e9/_sampleRate);
+}
+
+int SoapyStreamHistory::find(const long long timeNs, unsigned long long &index)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_anchors.empty()) return SOAPY_SDR_TIME_ERROR;
+
+    //locate the last anchor at or before the requested time
+    auto it = std::upper_bound(_anchors.begin(), _anchors.end(), timeNs,
+        [](const long long t, const TimeAnchor &a){return t < a.timeNs;});
+    if (it != _anchors.begin()) --it;
+
+    const auto deltaElems = std::llround(double(timeNs - it->timeNs)*_sampleRate/1e9);
+    const long long result = (long long)(it->index) + deltaElems;
+
+    //the window must still be in the ring and not absurdly far into the future
+    const auto oldestIndex = (_writeCount > _capacity)?(_writeCount - _capacity):0;
+    if (result < 0 or (unsigned long long)(result) < oldestIndex) return SOAPY_SDR_TIME_ERROR;
+    if ((unsigned long long)(result) > _writeCount + _capacity) return SOAPY_SDR_TIME_ERROR;
+    index = (unsigned long long)(result);
+    return 0;
+}
+
+bool SoapyStreamHistory::hasTime(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return not _anchors.empty();
+}
+
+long long SoapyStreamHistory::timeAt(const unsigned long long index)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_anchors.empty()) return 0;
+
+    auto it = std::upper_bound(_anchors.begin(), _anchors.end(), index,
+        [](const unsigned long long i, const TimeAnchor &a){return i < a.index;});
+    if (it != _anchors.begin()) --it;
+    return this->anchorTime(*it, index);
+}
+
+unsigned long long SoapyStreamHistory::oldest(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_writeCount > _capacity)?(_writeCount - _capacity):0;
+}
+
+unsigned long long SoapyStreamHistory::newest(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _writeCount;
+}
+
+bool SoapyStreamHistory::waitAvailable(const unsigned long long index, const long timeoutUs)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _cond.wait_for(lock, std::chrono::microseconds(timeoutUs),
+        [this, index]{return _writeCount > index;});
+}
+
+int SoapyStreamHistory::read(const unsigned long long index, void * const *buffs, const size_t numElems)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    //the requested samples were already overwritten
+    const auto oldestIndex = (_writeCount > _capacity)?(_writeCount - _capacity):0;
+    if (index < oldestIndex) return SOAPY_SDR_OVERFLOW;
+    if (index >= _writeCount) return 0;
+
+    const size_t count = size_t(std::min<unsigned long long>(numElems, _writeCount - index));
+    const size_t offset = size_t(index % _capacity);
+    const size_t first = std::min(count, _capacity - offset);
+    for (size_t i = 0; i < _numChans; i++)
+    {
+        const char *base = _mem + (i*_capacity*_elemSize);
+        char *out = (char *)buffs[i];
+        std::memcpy(out, base + offset*_elemSize, first*_elemSize);
+        std::memcpy(out + first*_elemSize, base, (count-first)*_elemSize);
+    }
+    return int(count);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <cstddef>
+#include <condition_variable>
+#include <mutex>
+#include <deque>
+
+/*!
+ * The stream history keeps the last N samples of a receive stream
+ * in a large preallocated ring buffer that is indexed by hardware time.
+ * The reader thread appends every block read from the device,
+ * independent of the client, and the live stream and replay streams
+ * read windows back out of the ring.
+ *
+ * Samples are addressed by an absolute index which counts every
+ * element appended since the history was created; the ring holds
+ * the elements in the range [oldest(), newest()).
+ */
+class SoapyStreamHistory
+{
+public:
+    SoapyStreamHistory(const size_t numChans, const size_t elemSize, const size_t numElems, const double sampleRate);
+
+    ~SoapyStreamHistory(void);
+
+    //! The number of elements that the ring can hold
+    size_t capacity(void) const
+    {
+        return _capacity;
+    }
+
+    //! The sample rate used to convert between time and index
+    double sampleRate(void) const
+    {
+        return _sampleRate;
+    }
+
+    //! Append a block of samples from the device (reader thread)
+    void append(const void * const *buffs, const size_t numElems, const int flags, const long long timeNs);
+
+    /*!
+     * Convert a hardware time into an absolute sample index.
+     * Return 0 on success or a SoapySDR error code when the
+     * time is not covered by the history (SOAPY_SDR_TIME_ERROR).
+     */
+    int find(const long long timeNs, unsigned long long &index);
+
+    //! True when appended blocks carried a hardware time
+    bool hasTime(void);
+
+    //! Convert an absolute sample index back into a hardware time
+    long long timeAt(const unsigned long long index);
+
+    //! The absolute index of the oldest element in the ring
+    unsigned long long oldest(void);
+
+    //! The absolute index one past the newest element in the ring
+    unsigned long long newest(void);
+
+    /*!
+     * Wait for the element at the given index to become available.
+     * Return true when available, false for timeout.
+     */
+    bool waitAvailable(const unsigned long long index, const long timeoutUs);
+
+    /*!
+     * Copy elements starting at the absolute index into the buffers.
+     * Return the number of elements copied (possibly 0 when not yet
+     * available) or SOAPY_SDR_OVERFLOW when the data was overwritten.
+     */
+    int read(const unsigned long long index, void * const *buffs, const size_t numElems);
+
+private:
+    const size_t _numChans;
+    const size_t _elemSize;
+    const size_t _capacity;
+    const double _sampleRate;
+
+    //ring memory, one contiguous region per channel
+    char *_mem;
+    size_t _memSize;
+    bool _mapped;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    unsigned long long _writeCount;
+
+    //time anchors: the absolute index of a block with a hardware time
+    struct TimeAnchor
+    {
+        unsigned long long index;
+        long long timeNs;
+    };
+    std::deque<TimeAnchor> _anchors;
+
+    long long anchorTime(const TimeAnchor &anchor, const unsigned long long index) const;
+};
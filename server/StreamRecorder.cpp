@@ -0,0 +1,418 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "StreamRecorder.hpp"
+#include "SoapyInfoUtils.hpp"
+#include <SoapySDR/Formats.hpp>
+#include <SoapySDR/Logger.hpp>
+#include <algorithm> //min
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <iomanip> //setprecision
+#include <cstring> //memcpy, strerror
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <malloc.h> //_aligned_malloc
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+//! Size of each write to the disk, large writes keep the disk streaming
+static const size_t BLOCK_SIZE = 4*1024*1024;
+
+//! Number of blocks in the pool, the amount of disk stall that can be absorbed
+static const size_t NUM_BLOCKS = 16;
+
+//! Buffer, length, and offset alignment required for direct I/O
+static const size_t DIRECT_ALIGN = 4096;
+
+/***********************************************************************
+ * Helpers
+ **********************************************************************/
+static std::string formatToSigMF(const std::string &format)
+{
+    if (format == SOAPY_SDR_CF64) return "cf64_le";
+    if (format == SOAPY_SDR_CF32) return "cf32_le";
+    if (format == SOAPY_SDR_CS32) return "ci32_le";
+    if (format == SOAPY_SDR_CU32) return "cu32_le";
+    if (format == SOAPY_SDR_CS16) return "ci16_le";
+    if (format == SOAPY_SDR_CU16) return "cu16_le";
+    if (format == SOAPY_SDR_CS8) return "ci8";
+    if (format == SOAPY_SDR_CU8) return "cu8";
+    if (format == SOAPY_SDR_F64) return "rf64_le";
+    if (format == SOAPY_SDR_F32) return "rf32_le";
+    if (format == SOAPY_SDR_S32) return "ri32_le";
+    if (format == SOAPY_SDR_U32) return "ru32_le";
+    if (format == SOAPY_SDR_S16) return "ri16_le";
+    if (format == SOAPY_SDR_U16) return "ru16_le";
+    if (format == SOAPY_SDR_S8) return "ri8";
+    if (format == SOAPY_SDR_U8) return "ru8";
+    return "";
+}
+
+static std::string utcDatetime(void)
+{
+    const auto now = std::chrono::system_clock::now();
+    const auto t = std::chrono::system_clock::to_time_t(now);
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count() % 1000000;
+    std::tm tm;
+    #ifdef _WIN32
+    gmtime_s(&tm, &t);
+    #else
+    gmtime_r(&t, &tm);
+    #endif
+    char date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+    char result[80];
+    std::snprintf(result, sizeof(result), "%s.%06dZ", date, int(us));
+    return result;
+}
+
+static std::string jsonEscape(const std::string &in)
+{
+    std::string out;
+    for (const char ch : in)
+    {
+        if (ch == '"' or ch == '\\') out.push_back('\\');
+        if ((unsigned char)(ch) < 0x20) continue;
+        out.push_back(ch);
+    }
+    return out;
+}
+
+static char *allocBlock(void)
+{
+    #ifdef _WIN32
+    void *mem = _aligned_malloc(BLOCK_SIZE, DIRECT_ALIGN);
+    #else
+    void *mem = nullptr;
+    if (posix_memalign(&mem, DIRECT_ALIGN, BLOCK_SIZE) != 0) mem = nullptr;
+    #endif
+    if (mem == nullptr) throw std::runtime_error("SoapyStreamRecorder() -- block allocation failed");
+    return (char *)mem;
+}
+
+static void freeBlock(char *mem)
+{
+    #ifdef _WIN32
+    _aligned_free(mem);
+    #else
+    std::free(mem);
+    #endif
+}
+
+/***********************************************************************
+ * Recorder implementation
+ **********************************************************************/
+SoapyStreamRecorder::SoapyStreamRecorder(const std::string &path, const std::string &format,
+    const double sampleRate, const double frequency, const std::string &hardware):
+    _datatype(formatToSigMF(format)),
+    _elemSize(SoapySDR::formatToSize(format)),
+    _sampleRate(sampleRate),
+    _frequency(frequency),
+    _hardware(hardware),
+    _fd(-1),
+    _direct(false),
+    _writer(nullptr),
+    _active(true),
+    _stopping(false),
+    _gap(true),
+    _samplesQueued(0),
+    _samplesDropped(0),
+    _bytesWritten(0),
+    _writeSeconds(0.0)
+{
+    if (_datatype.empty()) throw std::runtime_error(
+        "SoapyStreamRecorder() -- format "+format+" has no SigMF datatype");
+
+    //the path names the recording, strip any SigMF extension
+    std::string base(path);
+    for (const std::string ext : {".sigmf-data", ".sigmf-meta", ".sigmf"})
+    {
+        if (base.size() > ext.size() and base.compare(base.size()-ext.size(), ext.size(), ext) == 0)
+        {
+            base.resize(base.size()-ext.size());
+            break;
+        }
+    }
+    _dataPath = base + ".sigmf-data";
+    _metaPath = base + ".sigmf-meta";
+
+    //open the data file, bypass the page cache when supported
+    #ifdef _WIN32
+    _fd = _open(_dataPath.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    #else
+    #ifdef O_DIRECT
+    _fd = ::open(_dataPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if (_fd >= 0) _direct = true;
+    #endif //O_DIRECT
+    if (_fd < 0) _fd = ::open(_dataPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    #ifdef F_NOCACHE
+    if (_fd >= 0 and fcntl(_fd, F_NOCACHE, 1) == 0) _direct = true;
+    #endif //F_NOCACHE
+    #endif //_WIN32
+    if (_fd < 0) throw std::runtime_error(
+        "SoapyStreamRecorder() -- open("+_dataPath+") FAIL: " + std::strerror(errno));
+
+    //allocate the block pool up-front
+    _current.mem = nullptr;
+    _current.size = 0;
+    try
+    {
+        for (size_t i = 0; i < NUM_BLOCKS; i++)
+        {
+            _blocks.push_back(allocBlock());
+            _free.push_back(_blocks.back());
+        }
+    }
+    catch (...)
+    {
+        //dont leave the descriptor open or an empty recording behind
+        for (auto block : _blocks) freeBlock(block);
+        #ifdef _WIN32
+        _close(_fd);
+        #else
+        ::close(_fd);
+        #endif
+        _fd = -1;
+        std::remove(_dataPath.c_str());
+        std::remove(_metaPath.c_str());
+        throw;
+    }
+
+    _startTime = std::chrono::high_resolution_clock::now();
+    _stopTime = _startTime;
+    _writer = new std::thread(&SoapyStreamRecorder::writerWork, this);
+
+    SoapySDR::logf(SOAPY_SDR_INFO, "Recording %s (%s, %g Msps, %s)",
+        _dataPath.c_str(), _datatype.c_str(), _sampleRate/1e6, _direct?"direct I/O":"buffered I/O");
+}
+
+SoapyStreamRecorder::~SoapyStreamRecorder(void)
+{
+    this->stop();
+    for (auto block : _blocks) freeBlock(block);
+}
+
+void SoapyStreamRecorder::append(const void *buff, const size_t numElems)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (not _active) return;
+
+    const char *in = (const char *)buff;
+    size_t bytesLeft = numElems*_elemSize;
+    while (bytesLeft != 0)
+    {
+        //grab a free block, never wait on the writer
+        if (_current.mem == nullptr)
+        {
+            if (_free.empty()) break;
+            _current.mem = _free.front();
+            _current.size = 0;
+            _free.pop_front();
+        }
+
+        //start a new capture segment after dropped samples
+        if (_gap)
+        {
+            _segments.push_back(Segment{_samplesQueued, utcDatetime()});
+            _gap = false;
+        }
+
+        const size_t numBytes = std::min(bytesLeft, BLOCK_SIZE - _current.size);
+        std::memcpy(_current.mem + _current.size, in, numBytes);
+        _current.size += numBytes;
+        _samplesQueued += numBytes/_elemSize;
+        in += numBytes;
+        bytesLeft -= numBytes;
+
+        if (_current.size == BLOCK_SIZE)
+        {
+            _full.push_back(_current);
+            _current.mem = nullptr;
+            _cond.notify_one();
+        }
+    }
+
+    if (bytesLeft != 0)
+    {
+        _samplesDropped += bytesLeft/_elemSize;
+        _gap = true;
+    }
+}
+
+void SoapyStreamRecorder::writerWork(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        if (_full.empty() and _stopping) break;
+        if (_full.empty())
+        {
+            _cond.wait(lock);
+            continue;
+        }
+        Block block = _full.front();
+        _full.pop_front();
+        const bool failed = not _error.empty();
+        lock.unlock();
+
+        //direct I/O needs aligned lengths, pad the final partial block
+        //the file is truncated back to its true length when stopped
+        size_t length = block.size;
+        if (_direct and (length % DIRECT_ALIGN) != 0)
+        {
+            const size_t padded = ((length + DIRECT_ALIGN - 1)/DIRECT_ALIGN)*DIRECT_ALIGN;
+            std::memset(block.mem + length, 0, padded - length);
+            length = padded;
+        }
+
+        std::string errorMsg;
+        const auto t0 = std::chrono::high_resolution_clock::now();
+        size_t offset = 0;
+        while (not failed and offset < length)
+        {
+            #ifdef _WIN32
+            const int ret = _write(_fd, block.mem + offset, unsigned(length - offset));
+            #else
+            const ssize_t ret = ::write(_fd, block.mem + offset, length - offset);
+            #ifdef O_DIRECT
+            //some filesystems accept O_DIRECT on open but reject the writes
+            if (ret < 0 and errno == EINVAL and _direct)
+            {
+                fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_DIRECT);
+                _direct = false;
+                length = block.size;
+                continue;
+            }
+            #endif //O_DIRECT
+            #endif //_WIN32
+            if (ret < 0 and errno == EINTR) continue;
+            if (ret <= 0)
+            {
+                errorMsg = std::strerror(errno);
+                break;
+            }
+            offset += size_t(ret);
+        }
+        const auto t1 = std::chrono::high_resolution_clock::now();
+
+        lock.lock();
+        if (not failed)
+        {
+            _writeSeconds += std::chrono::duration<double>(t1 - t0).count();
+            if (errorMsg.empty()) _bytesWritten += block.size;
+        }
+        if (not errorMsg.empty() and _error.empty())
+        {
+            _error = errorMsg;
+            _active = false;
+            SoapySDR::logf(SOAPY_SDR_ERROR, "Recording %s write FAIL: %s", _dataPath.c_str(), errorMsg.c_str());
+        }
+        _free.push_back(block.mem);
+    }
+}
+
+void SoapyStreamRecorder::stop(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_writer == nullptr) return;
+        _active = false;
+        if (_current.mem != nullptr)
+        {
+            if (_current.size != 0) _full.push_back(_current);
+            else _free.push_back(_current.mem);
+            _current.mem = nullptr;
+        }
+        _stopping = true;
+        _stopTime = std::chrono::high_resolution_clock::now();
+        _cond.notify_all();
+    }
+
+    _writer->join();
+    delete _writer;
+    _writer = nullptr;
+
+    //remove the padding from the final direct write and close
+    #ifdef _WIN32
+    _chsize_s(_fd, (long long)(_bytesWritten));
+    _close(_fd);
+    #else
+    if (ftruncate(_fd, off_t(_bytesWritten)) != 0)
+    {
+        SoapySDR::logf(SOAPY_SDR_WARNING, "Recording %s truncate FAIL: %s", _dataPath.c_str(), std::strerror(errno));
+    }
+    ::close(_fd);
+    #endif
+    _fd = -1;
+
+    this->writeMeta();
+
+    SoapySDR::logf(SOAPY_SDR_INFO, "Recording %s stopped: %llu samples written, %llu dropped",
+        _dataPath.c_str(), _bytesWritten/_elemSize, _samplesDropped);
+}
+
+void SoapyStreamRecorder::writeMeta(void)
+{
+    if (_segments.empty()) _segments.push_back(Segment{0, utcDatetime()});
+
+    std::ostringstream ss;
+    ss << std::setprecision(17);
+    ss << "{" << std::endl;
+    ss << "    \"global\": {" << std::endl;
+    ss << "        \"core:datatype\": \"" << _datatype << "\"," << std::endl;
+    ss << "        \"core:sample_rate\": " << _sampleRate << "," << std::endl;
+    ss << "        \"core:version\": \"1.0.0\"," << std::endl;
+    ss << "        \"core:num_channels\": 1," << std::endl;
+    ss << "        \"core:hw\": \"" << jsonEscape(_hardware) << "\"," << std::endl;
+    ss << "        \"core:recorder\": \"SoapySDRServer " << jsonEscape(SoapyInfo::getServerVersion()) << "\"" << std::endl;
+    ss << "    }," << std::endl;
+    ss << "    \"captures\": [" << std::endl;
+    for (size_t i = 0; i < _segments.size(); i++)
+    {
+        ss << "        {" << std::endl;
+        ss << "            \"core:sample_start\": " << _segments[i].sampleStart << "," << std::endl;
+        ss << "            \"core:frequency\": " << _frequency << "," << std::endl;
+        ss << "            \"core:datetime\": \"" << _segments[i].datetime << "\"" << std::endl;
+        ss << "        }" << ((i+1 == _segments.size())?"":",") << std::endl;
+    }
+    ss << "    ]," << std::endl;
+    ss << "    \"annotations\": []" << std::endl;
+    ss << "}" << std::endl;
+
+    std::ofstream meta(_metaPath.c_str(), std::ios::out | std::ios::trunc);
+    meta << ss.str();
+    if (not meta) SoapySDR::logf(SOAPY_SDR_ERROR, "Recording %s metadata write FAIL", _metaPath.c_str());
+}
+
+SoapySDR::Kwargs SoapyStreamRecorder::status(void)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto endTime = (_writer != nullptr)?std::chrono::high_resolution_clock::now():_stopTime;
+    const double elapsed = std::chrono::duration<double>(endTime - _startTime).count();
+
+    SoapySDR::Kwargs result;
+    result["path"] = _dataPath;
+    result["active"] = _active?"true":"false";
+    result["direct"] = _direct?"true":"false";
+    result["elapsed"] = std::to_string(elapsed);
+    result["samples"] = std::to_string(_samplesQueued);
+    result["written"] = std::to_string(_bytesWritten/_elemSize);
+    result["dropped"] = std::to_string(_samplesDropped);
+    result["bytes"] = std::to_string(_bytesWritten);
+    result["rate"] = std::to_string((elapsed > 0.0)?(_bytesWritten/elapsed/1e6):0.0); //MB/s
+    result["disk_rate"] = std::to_string((_writeSeconds > 0.0)?(_bytesWritten/_writeSeconds/1e6):0.0); //MB/s
+    result["buffered"] = std::to_string(_full.size()*BLOCK_SIZE);
+    if (not _error.empty()) result["error"] = _error;
+    return result;
+}
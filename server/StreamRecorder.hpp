@@ -0,0 +1,98 @@
+// Copyright (c) 2026-2026 SoapyRemote contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#pragma once
+#include <SoapySDR/Types.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+/*!
+ * The stream recorder tees one channel of a receive stream to disk.
+ * A record-only stream feeds the recorders from a server-side reader thread,
+ * otherwise the samples are teed from the stream forwarded to the client.
+ * The output is a SigMF recording: the samples go to a .sigmf-data file
+ * and a .sigmf-meta file with the capture description is written on stop.
+ *
+ * The stream thread copies samples into a pool of large aligned blocks
+ * and never blocks on the disk; a dedicated writer thread writes full blocks
+ * with direct I/O when the filesystem supports it. Samples that arrive when
+ * no free block is available are dropped, counted, and marked in the metadata
+ * with a new capture segment where the recording resumes.
+ */
+class SoapyStreamRecorder
+{
+public:
+    SoapyStreamRecorder(const std::string &path, const std::string &format,
+        const double sampleRate, const double frequency, const std::string &hardware);
+
+    //! Stops the recording when still active
+    ~SoapyStreamRecorder(void);
+
+    //! Append samples for the recorded channel (stream thread)
+    void append(const void *buff, const size_t numElems);
+
+    //! Flush the remaining samples, close the data file and write the metadata
+    void stop(void);
+
+    //! Progress, drop and throughput statistics
+    SoapySDR::Kwargs status(void);
+
+private:
+    void writerWork(void);
+    void writeMeta(void);
+
+    std::string _dataPath;
+    std::string _metaPath;
+    std::string _datatype;
+    const size_t _elemSize;
+    const double _sampleRate;
+    const double _frequency;
+    const std::string _hardware;
+
+    //output file descriptor and direct I/O mode,
+    //the writer thread clears direct mode on fallback
+    int _fd;
+    std::atomic<bool> _direct;
+
+    //block pool shared with the writer thread
+    struct Block
+    {
+        char *mem;
+        size_t size;
+    };
+    std::vector<char *> _blocks;
+    std::deque<Block> _full;
+    std::deque<char *> _free;
+    Block _current;
+
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::thread *_writer;
+    bool _active;
+    bool _stopping;
+    std::string _error;
+
+    //capture segments (sample index and UTC time) for the metadata
+    struct Segment
+    {
+        unsigned long long sampleStart;
+        std::string datetime;
+    };
+    std::vector<Segment> _segments;
+    bool _gap;
+
+    //statistics
+    std::chrono::high_resolution_clock::time_point _startTime;
+    std::chrono::high_resolution_clock::time_point _stopTime;
+    unsigned long long _samplesQueued;
+    unsigned long long _samplesDropped;
+    unsigned long long _bytesWritten;
+    double _writeSeconds;
+};